@@ -20,7 +20,12 @@ SOURCES += \
     mainwindow.cpp \
     ../src/Polynomial.cpp \
     ../src/PolynomialRing.cpp \
-    ../src/PolynomialField.cpp
+    ../src/PolynomialField.cpp \
+    ../src/Multiplication.cpp \
+    ../src/FieldMultiplicationCache.cpp \
+    ../src/Factorization.cpp \
+    ../src/ModMatrix.cpp \
+    ../src/BinaryMatrix.cpp
 
 
 HEADERS += \
@@ -28,7 +33,14 @@ HEADERS += \
     ../src/Polynomial.cpp \
     ../src/PolynomialRing.cpp \
     ../src/PolynomialField.cpp \
-    ../src/FieldMultiplicationCache.hpp
+    ../src/FieldMultiplicationCache.hpp \
+    ../src/HashTable.hpp \
+    ../src/SmallVector.hpp \
+    ../src/Multiplication.hpp \
+    ../src/ModularArithmetic.hpp \
+    ../src/Factorization.hpp \
+    ../src/ModMatrix.hpp \
+    ../src/BinaryMatrix.hpp
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,179 @@
+#include "BinaryMatrix.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace lab::detail {
+
+namespace {
+constexpr size_t WORD_BITS = 64;
+
+void xorRow(uint64_t* target, const uint64_t* source, size_t first_word, size_t words) {
+    for (size_t w = first_word; w < words; w++) {
+        target[w] ^= source[w];
+    }
+}
+}
+
+BinaryMatrix::BinaryMatrix(size_t rows, size_t columns)
+        : _rows{rows},
+          _columns{columns},
+          _words{(columns + WORD_BITS - 1) / WORD_BITS},
+          _data(rows * _words, 0) {}
+
+BinaryMatrix::BinaryMatrix(const std::vector<std::vector<uint64_t>>& entries)
+        : BinaryMatrix(entries.size(), entries.empty() ? 0 : entries[0].size()) {
+    for (size_t i = 0; i < _rows; i++) {
+        assert(entries[i].size() == _columns);
+        for (size_t j = 0; j < _columns; j++) {
+            set(i, j, entries[i][j] & 1);
+        }
+    }
+}
+
+size_t BinaryMatrix::rows() const {
+    return _rows;
+}
+
+size_t BinaryMatrix::columns() const {
+    return _columns;
+}
+
+bool BinaryMatrix::get(size_t row, size_t column) const {
+    return (_data[row * _words + column / WORD_BITS] >> (column % WORD_BITS)) & 1;
+}
+
+void BinaryMatrix::set(size_t row, size_t column, bool value) {
+    auto& word = _data[row * _words + column / WORD_BITS];
+    const auto mask = uint64_t{1} << (column % WORD_BITS);
+    word = value ? word | mask : word & ~mask;
+}
+
+uint64_t* BinaryMatrix::_row(size_t row) {
+    return _data.data() + row * _words;
+}
+
+std::vector<size_t> BinaryMatrix::eliminate(bool reduced) {
+    std::vector<size_t> pivots;
+    std::vector<uint64_t> table(_words << M4RI_BLOCK);
+
+    for (size_t start = 0; start < _columns && pivots.size() < _rows; start += M4RI_BLOCK) {
+        const auto end = std::min(start + M4RI_BLOCK, _columns);
+        const auto first_word = start / WORD_BITS;
+        const auto rank = pivots.size();
+        const auto block_begin = pivots.size();
+
+        // ordinary elimination restricted to the block: every candidate is cleared by the pivots found so far
+        // in the block, so rows passed over stay zero in columns without a pivot
+        for (size_t column = start; column < end && pivots.size() < _rows; column++) {
+            const auto found = pivots.size() - block_begin;
+            for (size_t i = pivots.size(); i < _rows; i++) {
+                auto* row = _row(i);
+                for (size_t t = 0; t < found; t++) {
+                    if (get(i, pivots[block_begin + t])) {
+                        xorRow(row, _row(rank + t), first_word, _words);
+                    }
+                }
+                if (get(i, column)) {
+                    std::swap_ranges(row, row + _words, _row(pivots.size()));
+                    pivots.push_back(column);
+                    break;
+                }
+            }
+        }
+
+        const auto found = pivots.size() - block_begin;
+        if (found == 0) {
+            continue;
+        }
+
+        // the pivot rows get a single 1 among the pivot columns of the block, the later ones already have
+        // zeros at the earlier pivots
+        for (size_t t = found; t-- > 0;) {
+            for (size_t s = 0; s < t; s++) {
+                if (get(rank + s, pivots[block_begin + t])) {
+                    xorRow(_row(rank + s), _row(rank + t), first_word, _words);
+                }
+            }
+        }
+
+        // table[index] is the sum of the pivot rows selected by the bits of index, table[0] stays zero
+        for (size_t index = 1; index < (size_t{1} << found); index++) {
+            auto* entry = table.data() + index * _words;
+            const auto* previous = table.data() + (index & (index - 1)) * _words;
+            const auto* pivot_row = _row(rank + __builtin_ctzll(index));
+            for (size_t w = first_word; w < _words; w++) {
+                entry[w] = previous[w] ^ pivot_row[w];
+            }
+        }
+
+        for (size_t i = reduced ? 0 : rank + found; i < _rows; i++) {
+            if (i == rank) {
+                i += found - 1;
+                continue;
+            }
+            size_t index = 0;
+            for (size_t t = 0; t < found; t++) {
+                index |= static_cast<size_t>(get(i, pivots[block_begin + t])) << t;
+            }
+            if (index != 0) {
+                xorRow(_row(i), table.data() + index * _words, first_word, _words);
+            }
+        }
+    }
+    return pivots;
+}
+
+size_t BinaryMatrix::rank() const {
+    auto copy = *this;
+    return copy.eliminate(false).size();
+}
+
+std::vector<std::vector<uint64_t>> BinaryMatrix::nullspace() const {
+    auto copy = *this;
+    const auto pivots = copy.eliminate(true);
+
+    std::vector<char> is_pivot(_columns, false);
+    for (const auto column : pivots) {
+        is_pivot[column] = true;
+    }
+
+    // every free column gives a vector with 1 there and its column entries at the pivots, as -1 == 1
+    std::vector<std::vector<uint64_t>> basis;
+    for (size_t free = 0; free < _columns; free++) {
+        if (is_pivot[free]) {
+            continue;
+        }
+        std::vector<uint64_t> vector(_columns, 0);
+        vector[free] = 1;
+        for (size_t k = 0; k < pivots.size(); k++) {
+            vector[pivots[k]] = copy.get(k, free);
+        }
+        basis.push_back(std::move(vector));
+    }
+    return basis;
+}
+
+std::optional<std::vector<uint64_t>> BinaryMatrix::solve(const std::vector<uint64_t>& rhs) const {
+    assert(rhs.size() == _rows);
+    BinaryMatrix augmented(_rows, _columns + 1);
+    for (size_t i = 0; i < _rows; i++) {
+        for (size_t j = 0; j < _columns; j++) {
+            augmented.set(i, j, get(i, j));
+        }
+        augmented.set(i, _columns, rhs[i] & 1);
+    }
+
+    const auto pivots = augmented.eliminate(true);
+    if (!pivots.empty() && pivots.back() == _columns) {
+        return std::nullopt;
+    }
+
+    std::vector<uint64_t> solution(_columns, 0);
+    for (size_t k = 0; k < pivots.size(); k++) {
+        solution[pivots[k]] = augmented.get(k, _columns);
+    }
+    return solution;
+}
+
+} // namespace lab::detail
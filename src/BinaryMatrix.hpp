@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lab::detail {
+
+/**
+ * @brief the largest count of columns eliminated at once by the Method of Four Russians, its tables hold
+ *        2^M4RI_BLOCK rows
+ */
+inline constexpr size_t M4RI_BLOCK = 8;
+
+/**
+ * @brief dense matrix over F_2 with 64 entries packed into every word of a flat row-major array
+ * @note elimination follows the Method of Four Russians: pivots are found for M4RI_BLOCK columns at a time,
+ *       all sums of the pivot rows are tabulated and every other row is cleared by a single table row
+ */
+class BinaryMatrix {
+public:
+    BinaryMatrix(size_t rows, size_t columns);
+
+    /**
+     * @note only the lowest bit of every entry is kept, all rows should have the same length
+     */
+    explicit BinaryMatrix(const std::vector<std::vector<uint64_t>>& entries);
+
+    [[nodiscard]]
+    size_t rows() const;
+
+    [[nodiscard]]
+    size_t columns() const;
+
+    [[nodiscard]]
+    bool get(size_t row, size_t column) const;
+
+    void set(size_t row, size_t column, bool value);
+
+    /**
+     * @brief brings the matrix to row echelon form, reduced form clears the pivot columns above the pivots as well
+     * @return pivot columns, the k-th of them holds the pivot of row k
+     */
+    std::vector<size_t> eliminate(bool reduced = true);
+
+    [[nodiscard]]
+    size_t rank() const;
+
+    /**
+     * @return basis of the right nullspace {x : A x = 0} with entries 0 and 1
+     */
+    [[nodiscard]]
+    std::vector<std::vector<uint64_t>> nullspace() const;
+
+    /**
+     * @return some x with A x = rhs, free variables set to zero, or nullopt if the system is inconsistent
+     */
+    [[nodiscard]]
+    std::optional<std::vector<uint64_t>> solve(const std::vector<uint64_t>& rhs) const;
+
+private:
+    uint64_t* _row(size_t row);
+
+    size_t _rows = 0;
+    size_t _columns = 0;
+    size_t _words = 0;
+    std::vector<uint64_t> _data;
+};
+
+} // namespace lab::detail
@@ -0,0 +1,224 @@
+#include "Factorization.hpp"
+#include "ModularArithmetic.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <mutex>
+#include <numeric>
+
+namespace lab::detail {
+
+namespace {
+    /**
+     * @return true if n passes the strong probable prime test to base a, where n - 1 = d * 2^s with odd d
+     */
+    bool strongProbablePrime(uint64_t n, uint64_t d, unsigned s, uint64_t a) {
+        auto x = powMod(a, d, n);
+        if (x == 1 || x == n - 1) {
+            return true;
+        }
+        for (unsigned i = 1; i < s; i++) {
+            x = mulMod(x, x, n);
+            if (x == n - 1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @return a non-trivial divisor of an odd composite n by Brent's variant of Pollard's rho,
+     *         gcd is taken once per a batch of products
+     */
+    uint64_t pollardBrent(uint64_t n) {
+        constexpr uint64_t BATCH = 128;
+
+        for (uint64_t c = 1;; c++) {
+            // x^2 + c mod n without overflow for n close to 2^64
+            const auto step = [n, c](uint64_t x) {
+                const auto square = mulMod(x, x, n);
+                return square >= n - c ? square - (n - c) : square + c;
+            };
+
+            uint64_t y = 2, x = 2, saved = 2;
+            uint64_t divisor = 1, product = 1;
+            for (uint64_t length = 1; divisor == 1; length <<= 1) {
+                x = y;
+                for (uint64_t i = 0; i < length; i++) {
+                    y = step(y);
+                }
+                for (uint64_t k = 0; k < length && divisor == 1; k += BATCH) {
+                    saved = y;
+                    for (uint64_t i = 0; i < std::min(BATCH, length - k); i++) {
+                        y = step(y);
+                        product = mulMod(product, x > y ? x - y : y - x, n);
+                    }
+                    divisor = std::gcd(product, n);
+                }
+            }
+
+            // the batch overshot to n, so it is walked again one step at a time
+            if (divisor == n) {
+                do {
+                    saved = step(saved);
+                    divisor = std::gcd(x > saved ? x - saved : saved - x, n);
+                } while (divisor == 1);
+            }
+
+            if (divisor != n) {
+                return divisor;
+            }
+        }
+    }
+
+    void collectFactors(uint64_t n, std::vector<uint64_t>& factors) {
+        if (n == 1) {
+            return;
+        }
+        if (isPrime(n)) {
+            factors.push_back(n);
+            return;
+        }
+        const auto divisor = pollardBrent(n);
+        collectFactors(divisor, factors);
+        collectFactors(n / divisor, factors);
+    }
+} // namespace
+
+bool isPrime(uint64_t n) {
+    // these bases are enough for a deterministic answer below 3.3 * 10^24
+    constexpr std::array<uint64_t, 12> BASES = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+    if (n < 2) {
+        return false;
+    }
+    for (const auto base : BASES) {
+        if (n % base == 0) {
+            return n == base;
+        }
+    }
+
+    auto d = n - 1;
+    unsigned s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+    return std::all_of(BASES.begin(), BASES.end(), [&](const auto base) {
+        return strongProbablePrime(n, d, s, base);
+    });
+}
+
+std::vector<uint64_t> primeFactors(uint64_t n) {
+    std::vector<uint64_t> factors;
+    if (n < 2 || LinearSieve::instance().factorize(n, factors)) {
+        return factors;
+    }
+
+    for (uint64_t i = 2; i < TRIAL_DIVISION_LIMIT && i * i <= n; i++) {
+        while (n % i == 0) {
+            factors.push_back(i);
+            n /= i;
+        }
+    }
+
+    // n has no factors below the limit now, so it is either prime or split by rho
+    if (n < TRIAL_DIVISION_LIMIT * TRIAL_DIVISION_LIMIT) {
+        if (n != 1) {
+            factors.push_back(n);
+        }
+    } else {
+        collectFactors(n, factors);
+    }
+
+    std::sort(factors.begin(), factors.end());
+    return factors;
+}
+
+uint64_t integerPow(uint64_t base, uint64_t power) {
+    uint64_t result = 1;
+    for (uint64_t i = 0; i < power; i++) {
+        assert((base == 0 || result <= UINT64_MAX / base) && "power does not fit into 64 bits");
+        result *= base;
+    }
+    return result;
+}
+
+LinearSieve& LinearSieve::instance() {
+    static LinearSieve sieve;
+    return sieve;
+}
+
+uint64_t LinearSieve::size() const {
+    std::shared_lock lock{_mutex};
+    return _size;
+}
+
+void LinearSieve::extend(uint64_t n) {
+    assert(n <= SIEVE_LIMIT && "sieve is limited by SIEVE_LIMIT");
+    {
+        std::shared_lock lock{_mutex};
+        if (n <= _size) {
+            return;
+        }
+    }
+
+    std::unique_lock lock{_mutex};
+    // another thread may have grown the tables while the lock was released
+    if (n > _size) {
+        _build(std::min(std::max(n, 2 * _size), SIEVE_LIMIT));
+    }
+}
+
+int8_t LinearSieve::moebius(uint64_t n) {
+    extend(n);
+    std::shared_lock lock{_mutex};
+    return _moebius[n];
+}
+
+std::vector<uint64_t> LinearSieve::primes(uint64_t n) {
+    extend(n);
+    std::shared_lock lock{_mutex};
+    return std::vector<uint64_t>(_primes.begin(), std::upper_bound(_primes.begin(), _primes.end(), n));
+}
+
+bool LinearSieve::factorize(uint64_t n, std::vector<uint64_t>& factors) const {
+    std::shared_lock lock{_mutex};
+    if (n > _size) {
+        return false;
+    }
+    for (; n > 1; n /= _smallest_factor[n]) {
+        factors.push_back(_smallest_factor[n]);
+    }
+    return true;
+}
+
+/*
+ * @note every composite i * prime is crossed out exactly once, by its smallest prime factor
+ */
+void LinearSieve::_build(uint64_t n) {
+    _smallest_factor.assign(n + 1, 0);
+    _moebius.assign(n + 1, 0);
+    _primes.clear();
+    _moebius[1] = 1;
+
+    for (uint64_t i = 2; i <= n; i++) {
+        if (_smallest_factor[i] == 0) {
+            _smallest_factor[i] = static_cast<uint32_t>(i);
+            _moebius[i] = -1;
+            _primes.push_back(static_cast<uint32_t>(i));
+        }
+        for (const uint64_t prime : _primes) {
+            if (prime > _smallest_factor[i] || i * prime > n) {
+                break;
+            }
+            _smallest_factor[i * prime] = static_cast<uint32_t>(prime);
+            _moebius[i * prime] = prime == _smallest_factor[i] ? 0 : static_cast<int8_t>(-_moebius[i]);
+        }
+    }
+
+    _size = n;
+}
+
+} // namespace lab::detail
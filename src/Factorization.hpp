@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <vector>
+
+namespace lab::detail {
+
+/**
+ * @brief numbers below this bound are factored by trial division only
+ */
+inline constexpr uint64_t TRIAL_DIVISION_LIMIT = 1 << 10;
+
+/**
+ * @brief deterministic Miller-Rabin test, exact for every 64-bit n
+ */
+bool isPrime(uint64_t n);
+
+/**
+ * @return prime factors of n with multiplicity in increasing order, empty for n < 2
+ * @note small factors are removed by trial division, the rest is split by Pollard-Brent rho
+ */
+std::vector<uint64_t> primeFactors(uint64_t n);
+
+/**
+ * @return base^power, which should fit into 64 bits
+ */
+uint64_t integerPow(uint64_t base, uint64_t power);
+
+/**
+ * @brief the sieve never grows beyond this bound, larger numbers are factored by primeFactors alone
+ * @note the tables take about 5 bytes per number, so the bound keeps them under 100 MB
+ */
+inline constexpr uint64_t SIEVE_LIMIT = uint64_t{1} << 24;
+
+/**
+ * @brief process-wide linear sieve with smallest prime factors and Moebius values of all numbers up to its size
+ * @note the tables grow lazily, at least doubling each time, and are rebuilt under an exclusive lock;
+ *       queries take a shared lock, so concurrent readers do not block each other
+ */
+class LinearSieve {
+public:
+    static LinearSieve& instance();
+
+    LinearSieve(const LinearSieve&) = delete;
+    LinearSieve& operator=(const LinearSieve&) = delete;
+
+    /**
+     * @return the largest number covered by the tables
+     */
+    [[nodiscard]]
+    uint64_t size() const;
+
+    /**
+     * @brief grows the tables so that they cover n, n should not exceed SIEVE_LIMIT
+     */
+    void extend(uint64_t n);
+
+    /**
+     * @return Moebius function of n, the tables grow up to n if needed
+     */
+    [[nodiscard]]
+    int8_t moebius(uint64_t n);
+
+    /**
+     * @return primes up to n in increasing order, the tables grow up to n if needed
+     */
+    [[nodiscard]]
+    std::vector<uint64_t> primes(uint64_t n);
+
+    /**
+     * @brief appends prime factors of n in increasing order by walking smallest prime factors
+     * @return false if n is not covered by the tables, which are not grown in this case
+     */
+    bool factorize(uint64_t n, std::vector<uint64_t>& factors) const;
+
+private:
+    LinearSieve() = default;
+
+    void _build(uint64_t n);
+
+    mutable std::shared_mutex _mutex;
+    uint64_t _size = 1;
+    // _smallest_factor[i] is the smallest prime dividing i for i >= 2
+    std::vector<uint32_t> _smallest_factor{0, 1};
+    std::vector<int8_t> _moebius{0, 1};
+    std::vector<uint32_t> _primes;
+};
+
+} // namespace lab::detail
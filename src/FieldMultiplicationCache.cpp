@@ -0,0 +1,211 @@
+#include "FieldMultiplicationCache.hpp"
+
+#include <functional>
+
+namespace lab::detail {
+
+namespace {
+    struct ThreadSlot {
+        bool valid = false;
+        uint64_t p = 0;
+        Polynomial irreducible;
+        Polynomial left;
+        Polynomial right;
+        Polynomial result;
+    };
+
+    struct ThreadCache {
+        uint64_t generation = 0;
+        std::array<ThreadSlot, FieldMultiplicationCache::THREAD_CACHE_SIZE> slots;
+    };
+
+    /**
+     * @return cache of the calling thread, emptied if the global cache was cleared since the last call
+     */
+    ThreadCache& threadCache(uint64_t generation) {
+        thread_local ThreadCache cache;
+        if (cache.generation != generation) {
+            for (auto& slot : cache.slots) {
+                slot.valid = false;
+            }
+            cache.generation = generation;
+        }
+        return cache;
+    }
+} // namespace
+
+FieldMultiplicationCache &FieldMultiplicationCache::instance() {
+    static FieldMultiplicationCache _instance;
+    return _instance;
+}
+
+/*
+ * @brief combines hashes of both factors, the order of factors matters
+ */
+size_t FieldMultiplicationCache::KeyHash::operator()(const Key& key) const {
+    const auto left = std::hash<Polynomial>{}(key.left);
+    const auto right = std::hash<Polynomial>{}(key.right);
+    return left ^ (right + 0x9e3779b97f4a7c15ull + (left << 6) + (left >> 2));
+}
+
+size_t FieldMultiplicationCache::FieldKeyHash::operator()(const FieldKey& key) const {
+    return std::hash<Polynomial>{}(key.second) ^ (key.first * 0x9e3779b97f4a7c15ull);
+}
+
+FieldMultiplicationCache::Key FieldMultiplicationCache::_makeKey(const Polynomial& left, const Polynomial& right) {
+    if (right < left) {
+        return Key{right, left};
+    }
+    return Key{left, right};
+}
+
+size_t FieldMultiplicationCache::_entryMemory(const Key& key, const Polynomial& result) {
+    // a hash table slot together with its share of free slots, and coefficient storage of all polynomials
+    constexpr size_t SLOT_SIZE = 2 * (sizeof(Key) + sizeof(Entry) + 4 * sizeof(uint64_t));
+    return SLOT_SIZE + sizeof(Polynomial::coefficient_type) * (key.left.coefficients().capacity()
+                                                               + key.right.coefficients().capacity()
+                                                               + result.coefficients().capacity());
+}
+
+std::shared_ptr<FieldMultiplicationCache::FieldCache> FieldMultiplicationCache::_findField(const FieldKey& field_key) const {
+    std::shared_lock lock{_fields_mutex};
+    const auto field = _fields.find(field_key);
+    return field ? *field : nullptr;
+}
+
+std::shared_ptr<FieldMultiplicationCache::FieldCache> FieldMultiplicationCache::_findOrCreateField(const FieldKey& field_key) {
+    if (auto field = _findField(field_key)) {
+        return field;
+    }
+
+    std::unique_lock lock{_fields_mutex};
+    if (const auto field = _fields.find(field_key)) {
+        return *field;
+    }
+
+    // lookups only take a shared lock and can't reorder the table, so recency of fields is kept in last_used
+    if (_fields.size() >= CAPACITY) {
+        const FieldKey* oldest_key = nullptr;
+        std::shared_ptr<FieldCache> oldest;
+        _fields.forEach([&](const FieldKey& key, const std::shared_ptr<FieldCache>& field) {
+            if (!oldest || field->last_used.load(std::memory_order_relaxed) < oldest->last_used.load(std::memory_order_relaxed)) {
+                oldest_key = &key;
+                oldest = field;
+            }
+        });
+
+        for (auto& shard : oldest->shards) {
+            std::lock_guard shard_lock{shard.mutex};
+            _evictions.fetch_add(shard.entries.size(), std::memory_order_relaxed);
+        }
+        // the key lives in the slot being erased
+        _fields.erase(FieldKey{*oldest_key});
+    }
+
+    auto field = std::make_shared<FieldCache>();
+    field->shard_budget = _memory_budget.load(std::memory_order_relaxed) / SHARDS_COUNT;
+    field->last_used.store(_clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+
+    _fields.insert(field_key, field);
+    return field;
+}
+
+std::optional<Polynomial> FieldMultiplicationCache::getResult(uint64_t p, const Polynomial& irreducible, const Polynomial& left, const Polynomial& right) {
+    auto key = _makeKey(left, right);
+    const auto hash = KeyHash{}(key);
+
+    auto& slot = threadCache(_generation.load(std::memory_order_acquire)).slots[hash % THREAD_CACHE_SIZE];
+    if (slot.valid && slot.p == p && slot.left == key.left && slot.right == key.right && slot.irreducible == irreducible) {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        return slot.result;
+    }
+
+    const auto field = _findField({p, irreducible});
+    if (!field) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    field->last_used.store(_clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+
+    auto& shard = field->shards[hash % SHARDS_COUNT];
+    std::optional<Polynomial> result;
+    {
+        std::lock_guard lock{shard.mutex};
+        if (const auto entry = shard.entries.get(key)) {
+            result = entry->result;
+        }
+    }
+
+    if (!result.has_value()) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    slot = ThreadSlot{true, p, irreducible, std::move(key.left), std::move(key.right), *result};
+    return result;
+}
+
+/*
+ * @note supposed that cache doesn't have results for either left * right or right * left
+ */
+void FieldMultiplicationCache::setResult(uint64_t p, const Polynomial& irreducible, const Polynomial& left, const Polynomial& right, const Polynomial& result) {
+    auto key = _makeKey(left, right);
+    const auto hash = KeyHash{}(key);
+
+    const auto field = _findOrCreateField({p, irreducible});
+    field->last_used.store(_clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+
+    auto& slot = threadCache(_generation.load(std::memory_order_acquire)).slots[hash % THREAD_CACHE_SIZE];
+    slot = ThreadSlot{true, p, irreducible, key.left, key.right, result};
+
+    auto& shard = field->shards[hash % SHARDS_COUNT];
+    std::lock_guard lock{shard.mutex};
+
+    if (shard.entries.get(key)) {
+        return;
+    }
+
+    const auto memory = _entryMemory(key, result);
+    shard.entries.insert(std::move(key), Entry{result, memory});
+    shard.memory += memory;
+
+    // the newest entry always stays, even if it alone exceeds the budget
+    while (shard.memory > field->shard_budget && shard.entries.size() > 1) {
+        shard.memory -= shard.entries.back().memory;
+        shard.entries.popBack();
+        _evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FieldMultiplicationCache::Stats FieldMultiplicationCache::stats() const {
+    Stats result;
+    result.hits = _hits.load(std::memory_order_relaxed);
+    result.misses = _misses.load(std::memory_order_relaxed);
+    result.evictions = _evictions.load(std::memory_order_relaxed);
+
+    std::shared_lock lock{_fields_mutex};
+    _fields.forEach([&result](const FieldKey&, const std::shared_ptr<FieldCache>& field) {
+        for (auto& shard : field->shards) {
+            std::lock_guard shard_lock{shard.mutex};
+            result.entries += shard.entries.size();
+            result.memory += shard.memory;
+        }
+    });
+    return result;
+}
+
+void FieldMultiplicationCache::clear() {
+    std::unique_lock lock{_fields_mutex};
+    _fields.clear();
+    _generation.fetch_add(1, std::memory_order_release);
+    _hits.store(0, std::memory_order_relaxed);
+    _misses.store(0, std::memory_order_relaxed);
+    _evictions.store(0, std::memory_order_relaxed);
+}
+
+void FieldMultiplicationCache::setMemoryBudget(size_t bytes_per_field) {
+    _memory_budget.store(bytes_per_field, std::memory_order_relaxed);
+}
+
+} // namespace lab::detail
@@ -1,72 +1,132 @@
 #pragma once
 
 #include "Polynomial.hpp"
+#include "HashTable.hpp"
 
-#include <utility>
-#include <queue>
-#include <map>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <utility>
 
 namespace lab {
 
 namespace detail {
 /*
  * @brief class for storage multiplication structures of polynomial fields
+ * @note safe to use from multiple threads: every field has its own sharded LRU cache with a memory budget,
+ *       and every thread keeps a small direct-mapped cache of its latest results in front of the shards
  */
 class FieldMultiplicationCache {
-    using MultiplicationStructure = std::map<std::pair<Polynomial, Polynomial>, Polynomial>;
 public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t memory = 0;
+    };
+
     FieldMultiplicationCache(const FieldMultiplicationCache &that) = delete;
     FieldMultiplicationCache(FieldMultiplicationCache &&that) = delete;
 
     FieldMultiplicationCache &operator=(const FieldMultiplicationCache &that) = delete;
     FieldMultiplicationCache &operator=(FieldMultiplicationCache &&that) = delete;
 
-    static FieldMultiplicationCache &instance() {
-        static FieldMultiplicationCache _instance;
-        return _instance;
-    }
-
-    std::optional<Polynomial> getResult(uint64_t p, const Polynomial& irreducible, const Polynomial& left, const Polynomial& right) {
-        const auto cache_item = cache_map.find({p, irreducible});
-        if (cache_item != cache_map.end()) {
-            if (cache_item->second.find({left, right}) != cache_item->second.end()) {
-                return cache_item->second[{left, right}];
-            }
-            if (cache_item->second.find({right, left}) != cache_item->second.end()) {
-                return cache_item->second[{right, left}];
-            }
-        }
+    static FieldMultiplicationCache &instance();
 
-        return std::nullopt;
-    }
+    std::optional<Polynomial> getResult(uint64_t p, const Polynomial& irreducible, const Polynomial& left, const Polynomial& right);
 
-    /*
-     * @note supposed that cache doesn't have results for either left * right or right * left
+    void setResult(uint64_t p, const Polynomial& irreducible, const Polynomial& left, const Polynomial& right, const Polynomial& result);
+
+    /**
+     * @return counters accumulated since the last clear()
      */
-    void setResult(uint64_t p, const Polynomial& irreducible, const Polynomial& left, const Polynomial& right, const Polynomial& result) {
-        const auto cache_item = cache_map.find({p, irreducible});
-        if (cache_item == cache_map.end()) {
-            auto it = cache_map.emplace(std::pair{p, irreducible}, MultiplicationStructure()).first;
-
-            if (cache_map.size() > CAPACITY) {
-                cache_map.erase(cache_iterators.front());
-                cache_iterators.pop();
-                cache_iterators.push(it);
-            }
-        }
+    [[nodiscard]]
+    Stats stats() const;
+
+    /**
+     * @brief drops all cached results and resets counters
+     */
+    void clear();
+
+    /**
+     * @brief sets how many bytes results of a single field may take, applies to fields created afterwards
+     */
+    void setMemoryBudget(size_t bytes_per_field);
+
+    // the maximum count of fields which have cached results at the same time
+    static inline constexpr size_t CAPACITY = 20;
+
+    static inline constexpr size_t SHARDS_COUNT = 16;
+
+    static inline constexpr size_t DEFAULT_MEMORY_BUDGET = size_t{64} << 20;
 
-        cache_map[{p, irreducible}][{left, right}] = result;
-    }
+    // size of the per-thread direct-mapped cache
+    static inline constexpr size_t THREAD_CACHE_SIZE = 64;
 
 private:
     FieldMultiplicationCache() = default;
 
-    static inline constexpr size_t CAPACITY = 20;
+    // pair of factors ordered so that left * right and right * left share one entry
+    struct Key {
+        Polynomial left;
+        Polynomial right;
+
+        friend bool operator==(const Key& a, const Key& b) {
+            return a.left == b.left && a.right == b.right;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Polynomial result;
+        size_t memory = 0;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        // keeps entries in LRU order
+        HashTable<Key, Entry, KeyHash> entries;
+        size_t memory = 0;
+    };
+
+    struct FieldCache {
+        size_t shard_budget;
+        std::atomic<uint64_t> last_used;
+        std::array<Shard, SHARDS_COUNT> shards;
+    };
+
+    using FieldKey = std::pair<uint64_t, Polynomial>;
+
+    struct FieldKeyHash {
+        size_t operator()(const FieldKey& key) const;
+    };
+
+    static Key _makeKey(const Polynomial& left, const Polynomial& right);
+
+    static size_t _entryMemory(const Key& key, const Polynomial& result);
+
+    std::shared_ptr<FieldCache> _findField(const FieldKey& field_key) const;
+
+    std::shared_ptr<FieldCache> _findOrCreateField(const FieldKey& field_key);
+
+    mutable std::shared_mutex _fields_mutex;
+    HashTable<FieldKey, std::shared_ptr<FieldCache>, FieldKeyHash> _fields;
 
-    std::queue<std::map<std::pair<uint64_t, Polynomial>, MultiplicationStructure>::iterator> cache_iterators;
+    std::atomic<size_t> _memory_budget{DEFAULT_MEMORY_BUDGET};
+    std::atomic<uint64_t> _clock{0};
+    // bumped by clear() so that per-thread caches drop their entries
+    std::atomic<uint64_t> _generation{0};
 
-    std::map<std::pair<uint64_t, Polynomial>, MultiplicationStructure> cache_map;
+    std::atomic<uint64_t> _hits{0};
+    std::atomic<uint64_t> _misses{0};
+    std::atomic<uint64_t> _evictions{0};
 };
 }
 
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace lab::detail {
+
+/**
+ * @brief Open-addressing hash table with linear probing, which also keeps its entries in recency order
+ * @note a lookup costs one hash computation and one key comparison for every slot with an equal full hash;
+ *       the least recently used entry is available through back() so the table can serve as an LRU cache
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class HashTable {
+public:
+    HashTable() = default;
+
+    [[nodiscard]]
+    size_t size() const {
+        return _size;
+    }
+
+    [[nodiscard]]
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * @return pointer to the value stored for the key or nullptr, recency order is not changed
+     */
+    Value* find(const Key& key) {
+        const auto index = _find(key, _hash(key));
+        return index == NONE ? nullptr : &_slots[index].value;
+    }
+
+    const Value* find(const Key& key) const {
+        const auto index = _find(key, _hash(key));
+        return index == NONE ? nullptr : &_slots[index].value;
+    }
+
+    /**
+     * @return pointer to the value stored for the key or nullptr, the found entry becomes the most recently used
+     */
+    Value* get(const Key& key) {
+        const auto index = _find(key, _hash(key));
+        if (index == NONE) {
+            return nullptr;
+        }
+        _unlink(index);
+        _linkFront(index);
+        return &_slots[index].value;
+    }
+
+    /**
+     * @brief inserts the value or replaces the stored one, the entry becomes the most recently used
+     */
+    Value& insert(Key key, Value value) {
+        const auto hash = _hash(key);
+        if (const auto index = _find(key, hash); index != NONE) {
+            _slots[index].value = std::move(value);
+            _unlink(index);
+            _linkFront(index);
+            return _slots[index].value;
+        }
+
+        // tombstones are counted as well, so probing always meets an empty slot
+        if ((_size + _tombstones + 1) * MAX_LOAD_DENOMINATOR > _slots.size() * MAX_LOAD_NUMERATOR) {
+            _rehash();
+        }
+
+        const auto index = _findFree(hash);
+        auto& slot = _slots[index];
+        if (slot.state == State::DELETED) {
+            _tombstones--;
+        }
+        slot.state = State::FULL;
+        slot.hash = hash;
+        slot.key = std::move(key);
+        slot.value = std::move(value);
+        _linkFront(index);
+        _size++;
+        return slot.value;
+    }
+
+    /**
+     * @return true if the key was present
+     */
+    bool erase(const Key& key) {
+        const auto index = _find(key, _hash(key));
+        if (index == NONE) {
+            return false;
+        }
+        _erase(index);
+        return true;
+    }
+
+    /**
+     * @return key of the least recently used entry, the table must not be empty
+     */
+    const Key& backKey() const {
+        return _slots[_tail].key;
+    }
+
+    /**
+     * @return value of the least recently used entry, the table must not be empty
+     */
+    Value& back() {
+        return _slots[_tail].value;
+    }
+
+    /**
+     * @brief removes the least recently used entry, the table must not be empty
+     */
+    void popBack() {
+        _erase(_tail);
+    }
+
+    /**
+     * @brief calls function(key, value) for every entry from the most to the least recently used
+     */
+    template <typename Function>
+    void forEach(Function&& function) const {
+        for (auto index = _head; index != NONE; index = _slots[index].next) {
+            function(_slots[index].key, _slots[index].value);
+        }
+    }
+
+    void clear() {
+        _slots.clear();
+        _size = 0;
+        _tombstones = 0;
+        _head = NONE;
+        _tail = NONE;
+    }
+
+private:
+    enum class State : uint8_t { EMPTY, FULL, DELETED };
+
+    static inline constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Slot {
+        uint64_t hash = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        State state = State::EMPTY;
+        Key key{};
+        Value value{};
+    };
+
+    static inline constexpr size_t MIN_CAPACITY = 16;
+    static inline constexpr size_t MAX_LOAD_NUMERATOR = 3;
+    static inline constexpr size_t MAX_LOAD_DENOMINATOR = 4;
+
+    static uint64_t _hash(const Key& key) {
+        return static_cast<uint64_t>(Hash{}(key));
+    }
+
+    [[nodiscard]]
+    uint32_t _find(const Key& key, uint64_t hash) const {
+        if (_slots.empty()) {
+            return NONE;
+        }
+        const size_t mask = _slots.size() - 1;
+        for (size_t index = hash & mask;; index = (index + 1) & mask) {
+            const auto& slot = _slots[index];
+            if (slot.state == State::EMPTY) {
+                return NONE;
+            }
+            if (slot.state == State::FULL && slot.hash == hash && slot.key == key) {
+                return static_cast<uint32_t>(index);
+            }
+        }
+    }
+
+    [[nodiscard]]
+    uint32_t _findFree(uint64_t hash) const {
+        const size_t mask = _slots.size() - 1;
+        size_t index = hash & mask;
+        while (_slots[index].state == State::FULL) {
+            index = (index + 1) & mask;
+        }
+        return static_cast<uint32_t>(index);
+    }
+
+    void _unlink(uint32_t index) {
+        auto& slot = _slots[index];
+        (slot.prev == NONE ? _head : _slots[slot.prev].next) = slot.next;
+        (slot.next == NONE ? _tail : _slots[slot.next].prev) = slot.prev;
+        slot.prev = NONE;
+        slot.next = NONE;
+    }
+
+    void _linkFront(uint32_t index) {
+        auto& slot = _slots[index];
+        slot.prev = NONE;
+        slot.next = _head;
+        (_head == NONE ? _tail : _slots[_head].prev) = index;
+        _head = index;
+    }
+
+    void _erase(uint32_t index) {
+        _unlink(index);
+        auto& slot = _slots[index];
+        slot.state = State::DELETED;
+        slot.key = Key{};
+        slot.value = Value{};
+        _size--;
+        _tombstones++;
+    }
+
+    /**
+     * @brief drops tombstones and grows the table so that it is at most half full, recency order is kept
+     */
+    void _rehash() {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity < 2 * (_size + 1)) {
+            capacity <<= 1;
+        }
+
+        auto old_slots = std::exchange(_slots, std::vector<Slot>(capacity));
+        auto index = _tail;
+        _head = NONE;
+        _tail = NONE;
+        _tombstones = 0;
+
+        // going from the least recently used entry and pushing to the front restores the order
+        while (index != NONE) {
+            auto& old_slot = old_slots[index];
+            const auto new_index = _findFree(old_slot.hash);
+            auto& slot = _slots[new_index];
+            slot.state = State::FULL;
+            slot.hash = old_slot.hash;
+            slot.key = std::move(old_slot.key);
+            slot.value = std::move(old_slot.value);
+            _linkFront(new_index);
+            index = old_slot.prev;
+        }
+    }
+
+    std::vector<Slot> _slots;
+    size_t _size = 0;
+    size_t _tombstones = 0;
+    uint32_t _head = NONE;
+    uint32_t _tail = NONE;
+};
+
+} // namespace lab::detail
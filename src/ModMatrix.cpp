@@ -0,0 +1,201 @@
+#include "ModMatrix.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace lab::detail {
+
+namespace {
+// products of two residues below 2^32 fit into 64 bits, so several of them may be summed before reducing
+constexpr uint64_t MAX_DELAYED_MODULUS = uint64_t{1} << 32;
+}
+
+ModMatrix::ModMatrix(size_t rows, size_t columns, uint64_t modulus)
+        : _rows{rows},
+          _columns{columns},
+          _reducer{modulus},
+          _data(rows * columns, 0) {}
+
+ModMatrix::ModMatrix(const std::vector<std::vector<uint64_t>>& entries, uint64_t modulus)
+        : ModMatrix(entries.size(), entries.empty() ? 0 : entries[0].size(), modulus) {
+    for (size_t i = 0; i < _rows; i++) {
+        assert(entries[i].size() == _columns);
+        auto* row = _row(i);
+        for (size_t j = 0; j < _columns; j++) {
+            row[j] = _reducer.reduce(entries[i][j]);
+        }
+    }
+}
+
+size_t ModMatrix::rows() const {
+    return _rows;
+}
+
+size_t ModMatrix::columns() const {
+    return _columns;
+}
+
+uint64_t ModMatrix::modulus() const {
+    return _reducer.modulus();
+}
+
+uint64_t& ModMatrix::operator()(size_t row, size_t column) {
+    return _data[row * _columns + column];
+}
+
+uint64_t ModMatrix::operator()(size_t row, size_t column) const {
+    return _data[row * _columns + column];
+}
+
+uint64_t* ModMatrix::_row(size_t row) {
+    return _data.data() + row * _columns;
+}
+
+BinaryMatrix ModMatrix::_binary() const {
+    BinaryMatrix result(_rows, _columns);
+    for (size_t i = 0; i < _rows; i++) {
+        for (size_t j = 0; j < _columns; j++) {
+            result.set(i, j, (*this)(i, j) != 0);
+        }
+    }
+    return result;
+}
+
+std::vector<size_t> ModMatrix::eliminate(bool reduced) {
+    const auto p = modulus();
+    if (p == 2) {
+        auto binary = _binary();
+        const auto pivots = binary.eliminate(reduced);
+        for (size_t i = 0; i < _rows; i++) {
+            for (size_t j = 0; j < _columns; j++) {
+                (*this)(i, j) = binary.get(i, j);
+            }
+        }
+        return pivots;
+    }
+
+    // every update adds at most (p - 1)^2 to an entry, so this many of them fit on top of a residue
+    const auto square = (p - 1) * (p - 1);
+    const auto max_pending = p <= MAX_DELAYED_MODULUS && square != 0
+                             ? (std::numeric_limits<uint64_t>::max() - (p - 1)) / square
+                             : 0;
+    size_t pending = 0;
+
+    std::vector<size_t> pivots;
+    for (size_t column = 0; column < _columns && pivots.size() < _rows; column++) {
+        const auto rank = pivots.size();
+        size_t pivot = rank;
+        while (pivot < _rows && _reducer.reduce((*this)(pivot, column)) == 0) {
+            pivot++;
+        }
+        if (pivot == _rows) {
+            continue;
+        }
+        auto* pivot_row = _row(rank);
+        if (pivot != rank) {
+            std::swap_ranges(pivot_row, pivot_row + _columns, _row(pivot));
+        }
+
+        const auto inverse = inverseMod(_reducer.reduce(pivot_row[column]), p);
+        for (size_t j = 0; j < _columns; j++) {
+            pivot_row[j] = _reducer.multiply(_reducer.reduce(pivot_row[j]), inverse);
+        }
+
+        for (size_t other = reduced ? 0 : rank + 1; other < _rows; other++) {
+            auto* target = _row(other);
+            const auto factor = _reducer.reduce(target[column]);
+            if (other == rank || factor == 0) {
+                continue;
+            }
+            if (max_pending != 0) {
+                // target - factor * pivot == target + (p - factor) * pivot, kept unreduced; a plain
+                // multiply-add loop which the compiler vectorizes
+                const auto negated = p - factor;
+                for (size_t j = column; j < _columns; j++) {
+                    target[j] += negated * pivot_row[j];
+                }
+            } else {
+                for (size_t j = column; j < _columns; j++) {
+                    const auto term = _reducer.multiply(factor, pivot_row[j]);
+                    target[j] = target[j] >= term ? target[j] - term : target[j] + p - term;
+                }
+            }
+        }
+        pivots.push_back(column);
+
+        if (max_pending != 0 && ++pending == max_pending) {
+            for (auto& item : _data) {
+                item = _reducer.reduce(item);
+            }
+            pending = 0;
+        }
+    }
+
+    if (pending != 0) {
+        for (auto& item : _data) {
+            item = _reducer.reduce(item);
+        }
+    }
+    return pivots;
+}
+
+size_t ModMatrix::rank() const {
+    if (modulus() == 2) {
+        return _binary().rank();
+    }
+    auto copy = *this;
+    return copy.eliminate(false).size();
+}
+
+std::vector<std::vector<uint64_t>> ModMatrix::nullspace() const {
+    if (modulus() == 2) {
+        return _binary().nullspace();
+    }
+    auto copy = *this;
+    const auto pivots = copy.eliminate(true);
+    const auto p = modulus();
+
+    std::vector<char> is_pivot(_columns, false);
+    for (const auto column : pivots) {
+        is_pivot[column] = true;
+    }
+
+    // every free column gives a vector with 1 there and minus its column entries at the pivots
+    std::vector<std::vector<uint64_t>> basis;
+    for (size_t free = 0; free < _columns; free++) {
+        if (is_pivot[free]) {
+            continue;
+        }
+        std::vector<uint64_t> vector(_columns, 0);
+        vector[free] = 1;
+        for (size_t k = 0; k < pivots.size(); k++) {
+            const auto item = copy(k, free);
+            vector[pivots[k]] = item == 0 ? 0 : p - item;
+        }
+        basis.push_back(std::move(vector));
+    }
+    return basis;
+}
+
+std::optional<std::vector<uint64_t>> ModMatrix::solve(const std::vector<uint64_t>& rhs) const {
+    assert(rhs.size() == _rows);
+    ModMatrix augmented(_rows, _columns + 1, modulus());
+    for (size_t i = 0; i < _rows; i++) {
+        std::copy_n(_data.data() + i * _columns, _columns, augmented._row(i));
+        augmented(i, _columns) = _reducer.reduce(rhs[i]);
+    }
+
+    const auto pivots = augmented.eliminate(true);
+    if (!pivots.empty() && pivots.back() == _columns) {
+        return std::nullopt;
+    }
+
+    std::vector<uint64_t> solution(_columns, 0);
+    for (size_t k = 0; k < pivots.size(); k++) {
+        solution[pivots[k]] = augmented(k, _columns);
+    }
+    return solution;
+}
+
+} // namespace lab::detail
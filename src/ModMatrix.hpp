@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ModularArithmetic.hpp"
+#include "BinaryMatrix.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lab::detail {
+
+/**
+ * @brief dense matrix over F_p stored row-major in one flat array, with exact Gaussian elimination
+ * @note entries are kept in [0, modulus) between operations; for moduli up to 2^32 row updates are plain
+ *       multiply-adds reduced only when the accumulated sums could overflow 64 bits; for modulus 2 elimination,
+ *       rank and nullspace are computed on a BinaryMatrix
+ */
+class ModMatrix {
+public:
+    ModMatrix(size_t rows, size_t columns, uint64_t modulus);
+
+    /**
+     * @note entries are reduced modulo modulus, all rows should have the same length
+     */
+    ModMatrix(const std::vector<std::vector<uint64_t>>& entries, uint64_t modulus);
+
+    [[nodiscard]]
+    size_t rows() const;
+
+    [[nodiscard]]
+    size_t columns() const;
+
+    [[nodiscard]]
+    uint64_t modulus() const;
+
+    /**
+     * @note assigned values should lie in [0, modulus)
+     */
+    uint64_t& operator()(size_t row, size_t column);
+
+    uint64_t operator()(size_t row, size_t column) const;
+
+    /**
+     * @brief brings the matrix to row echelon form with unit pivots, reduced form clears the pivot columns above
+     *        the pivots as well
+     * @return pivot columns, the k-th of them holds the pivot of row k
+     */
+    std::vector<size_t> eliminate(bool reduced = true);
+
+    [[nodiscard]]
+    size_t rank() const;
+
+    /**
+     * @return basis of the right nullspace {x : A x = 0}
+     */
+    [[nodiscard]]
+    std::vector<std::vector<uint64_t>> nullspace() const;
+
+    /**
+     * @return some x with A x = rhs, free variables set to zero, or nullopt if the system is inconsistent
+     */
+    [[nodiscard]]
+    std::optional<std::vector<uint64_t>> solve(const std::vector<uint64_t>& rhs) const;
+
+private:
+    uint64_t* _row(size_t row);
+
+    [[nodiscard]]
+    BinaryMatrix _binary() const;
+
+    size_t _rows = 0;
+    size_t _columns = 0;
+    BarrettReducer _reducer;
+    std::vector<uint64_t> _data;
+};
+
+} // namespace lab::detail
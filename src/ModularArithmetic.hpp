@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace lab::detail {
+
+/**
+ * @return a * b % modulus without overflow for any 64-bit operands
+ */
+inline uint64_t mulMod(uint64_t a, uint64_t b, uint64_t modulus) {
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % modulus);
+}
+
+/**
+ * @return base^power % modulus
+ */
+inline uint64_t powMod(uint64_t base, uint64_t power, uint64_t modulus) {
+    uint64_t result = 1 % modulus;
+    base %= modulus;
+    while (power) {
+        if (power & 1) {
+            result = mulMod(result, base, modulus);
+        }
+        base = mulMod(base, base, modulus);
+        power >>= 1;
+    }
+    return result;
+}
+
+/**
+ * @return x such that a * x % modulus == 1, computed by the extended Euclidean algorithm
+ * @note a and modulus should be coprime
+ */
+inline uint64_t inverseMod(uint64_t a, uint64_t modulus) {
+    __int128 old_r = a % modulus, r = modulus;
+    __int128 old_t = 1, t = 0;
+    while (r != 0) {
+        const auto quotient = old_r / r;
+        old_r -= quotient * r;
+        std::swap(old_r, r);
+        old_t -= quotient * t;
+        std::swap(old_t, t);
+    }
+    if (old_t < 0) {
+        old_t += modulus;
+    }
+    return static_cast<uint64_t>(old_t);
+}
+
+/**
+ * @brief reduces integers modulo a fixed modulus by Barrett's method, without divisions and branches
+ * @note the modulus must be in [2, 2^63)
+ */
+class BarrettReducer {
+public:
+    BarrettReducer() = default;
+
+    explicit BarrettReducer(uint64_t modulus)
+            : _modulus{modulus},
+              _factor{~uint64_t{0} / modulus},
+              _wrap{(~uint64_t{0} % modulus + 1) % modulus} {}
+
+    [[nodiscard]]
+    uint64_t modulus() const {
+        return _modulus;
+    }
+
+    /**
+     * @return x mod modulus
+     */
+    [[nodiscard]]
+    uint64_t reduce(uint64_t x) const {
+        // the estimated quotient is at most one less than the exact one, so a single correction is enough
+        const auto quotient = static_cast<uint64_t>((static_cast<unsigned __int128>(x) * _factor) >> 64);
+        const auto remainder = x - quotient * _modulus;
+        return remainder - (_modulus & (0 - static_cast<uint64_t>(remainder >= _modulus)));
+    }
+
+    /**
+     * @return x mod modulus in [0, modulus) for a signed x
+     */
+    [[nodiscard]]
+    int64_t reduce(int64_t x) const {
+        // a negative x is read as x + 2^64, which is then compensated by subtracting 2^64 mod modulus
+        const auto remainder = reduce(static_cast<uint64_t>(x));
+        const auto correction = _wrap & static_cast<uint64_t>(x >> 63);
+        const auto result = remainder - correction;
+        return static_cast<int64_t>(result + (_modulus & (0 - static_cast<uint64_t>(remainder < correction))));
+    }
+
+    /**
+     * @brief reduces every item of data to [0, modulus)
+     */
+    void reduce(int64_t* data, size_t size) const {
+        for (size_t i = 0; i < size; i++) {
+            data[i] = reduce(data[i]);
+        }
+    }
+
+    /**
+     * @return a * b mod modulus for a, b in [0, modulus)
+     */
+    [[nodiscard]]
+    uint64_t multiply(uint64_t a, uint64_t b) const {
+        return _modulus <= MAX_SHORT_MODULUS ? reduce(a * b) : mulMod(a, b, _modulus);
+    }
+
+private:
+    // for moduli up to 2^32 the product of two residues fits into 64 bits
+    static inline constexpr uint64_t MAX_SHORT_MODULUS = uint64_t{1} << 32;
+
+    uint64_t _modulus = 1;
+    // floor((2^64 - 1) / modulus)
+    uint64_t _factor = 0;
+    // 2^64 mod modulus
+    uint64_t _wrap = 0;
+};
+
+} // namespace lab::detail
@@ -0,0 +1,384 @@
+#include "Multiplication.hpp"
+#include "ModularArithmetic.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace lab::detail {
+
+namespace {
+    // Arithmetic is done on unsigned values so that overflow wraps the same way in every kernel
+    using word = uint64_t;
+
+    /**
+     * @brief out += a * b, where a has n coefficients and b has m coefficients
+     */
+    void schoolbookInto(const word* a, size_t n, const word* b, size_t m, word* out) {
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < m; j++) {
+                out[i + j] += a[i] * b[j];
+            }
+        }
+    }
+
+    /**
+     * @brief out += a * b, where both a and b have n coefficients
+     */
+    void karatsubaInto(const word* a, const word* b, size_t n, word* out) {
+        if (n <= KARATSUBA_THRESHOLD) {
+            schoolbookInto(a, n, b, n, out);
+            return;
+        }
+
+        // a = a0 + x^low * a1, where a0 has low coefficients and a1 has high >= low coefficients
+        const size_t low = n / 2;
+        const size_t high = n - low;
+
+        std::vector<word> a_sum(a + low, a + n);
+        std::vector<word> b_sum(b + low, b + n);
+        for (size_t i = 0; i < low; i++) {
+            a_sum[i] += a[i];
+            b_sum[i] += b[i];
+        }
+
+        std::vector<word> z0(2 * low - 1, 0);
+        std::vector<word> z1(2 * high - 1, 0);
+        std::vector<word> z2(2 * high - 1, 0);
+
+        karatsubaInto(a, b, low, z0.data());
+        karatsubaInto(a + low, b + low, high, z2.data());
+        karatsubaInto(a_sum.data(), b_sum.data(), high, z1.data());
+
+        for (size_t i = 0; i < z0.size(); i++) {
+            z1[i] -= z0[i];
+            out[i] += z0[i];
+        }
+        for (size_t i = 0; i < z2.size(); i++) {
+            z1[i] -= z2[i];
+            out[i + 2 * low] += z2[i];
+        }
+        for (size_t i = 0; i < z1.size(); i++) {
+            out[i + low] += z1[i];
+        }
+    }
+
+    /**
+     * @brief out += a * b for operands of arbitrary lengths
+     * @note the longer operand is cut into pieces of the shorter operand's length
+     */
+    void multiplyInto(const word* a, size_t n, const word* b, size_t m, word* out) {
+        if (n < m) {
+            std::swap(a, b);
+            std::swap(n, m);
+        }
+
+        if (m <= KARATSUBA_THRESHOLD) {
+            schoolbookInto(a, n, b, m, out);
+            return;
+        }
+
+        for (size_t offset = 0; offset < n; offset += m) {
+            const size_t length = std::min(m, n - offset);
+            if (length == m) {
+                karatsubaInto(a + offset, b, m, out + offset);
+            } else {
+                multiplyInto(b, m, a + offset, length, out + offset);
+            }
+        }
+    }
+
+    struct NttPrime {
+        uint64_t modulus;
+        uint64_t root;
+    };
+
+    // Primes of form c * 2^k + 1 with k >= 23 and their primitive roots, the largest ones go first
+    constexpr std::array<NttPrime, 6> NTT_PRIMES = {{
+            {2113929217, 5},
+            {2013265921, 31},
+            {1811939329, 13},
+            {998244353, 3},
+            {754974721, 11},
+            {469762049, 3}
+    }};
+
+    /**
+     * @return x mod MODULUS for x < 2 * MODULUS, computed without branches
+     */
+    template <uint64_t MODULUS>
+    inline uint64_t reduceOnce(uint64_t x) {
+        const auto shifted = x - MODULUS;
+        return shifted + (MODULUS & (0 - (shifted >> 63)));
+    }
+
+    /**
+     * @brief twiddles of every level of a transform together with their Shoup quotients floor(w * 2^32 / p),
+     *        which turn every modular product in a butterfly into two multiplications and a shift
+     * @note the level of length 2 * half keeps its twiddles at positions half..2 * half - 1, so the tables of
+     *       a longer transform extend those of a shorter one
+     */
+    struct NttTwiddles {
+        std::vector<uint32_t> twiddles;
+        std::vector<uint32_t> quotients;
+    };
+
+    /**
+     * @return twiddles covering transforms of n points, built once per thread and extended on demand
+     */
+    template <size_t PRIME_INDEX>
+    const NttTwiddles& nttTwiddles(size_t n, bool inverse) {
+        constexpr auto MODULUS = NTT_PRIMES[PRIME_INDEX].modulus;
+        thread_local std::array<NttTwiddles, 2> cache;
+        auto& tables = cache[inverse];
+
+        for (size_t half = std::max<size_t>(tables.twiddles.size(), 1); half < n; half <<= 1) {
+            auto step = powMod(NTT_PRIMES[PRIME_INDEX].root, (MODULUS - 1) / (2 * half), MODULUS);
+            if (inverse) {
+                step = powMod(step, MODULUS - 2, MODULUS);
+            }
+            tables.twiddles.resize(2 * half);
+            tables.quotients.resize(2 * half);
+            uint64_t twiddle = 1;
+            for (size_t i = 0; i < half; i++) {
+                tables.twiddles[half + i] = static_cast<uint32_t>(twiddle);
+                tables.quotients[half + i] = static_cast<uint32_t>((twiddle << 32) / MODULUS);
+                twiddle = twiddle * step % MODULUS;
+            }
+        }
+        return tables;
+    }
+
+    /**
+     * @brief in-place iterative number-theoretic transform, size of data must be a power of 2
+     * @note the prime is a template parameter so that every % compiles to a multiplication
+     */
+    template <size_t PRIME_INDEX>
+    void ntt(std::vector<uint64_t>& data, bool inverse) {
+        constexpr auto MODULUS = NTT_PRIMES[PRIME_INDEX].modulus;
+        const size_t n = data.size();
+
+        for (size_t i = 1, j = 0; i < n; i++) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(data[i], data[j]);
+            }
+        }
+
+        const auto& tables = nttTwiddles<PRIME_INDEX>(n, inverse);
+        for (size_t half = 1; half < n; half <<= 1) {
+            const auto* twiddles = tables.twiddles.data() + half;
+            const auto* quotients = tables.quotients.data() + half;
+            for (size_t block = 0; block < n; block += 2 * half) {
+                auto* low = data.data() + block;
+                auto* high = low + half;
+                for (size_t i = 0; i < half; i++) {
+                    const auto u = low[i];
+                    const auto quotient = (high[i] * quotients[i]) >> 32;
+                    const auto v = reduceOnce<MODULUS>((high[i] * twiddles[i] - quotient * MODULUS) & 0xFFFFFFFFu);
+                    low[i] = reduceOnce<MODULUS>(u + v);
+                    high[i] = reduceOnce<MODULUS>(u + MODULUS - v);
+                }
+            }
+        }
+
+        if (inverse) {
+            const auto n_inverse = powMod(n, MODULUS - 2, MODULUS);
+            for (auto& item : data) {
+                item = item * n_inverse % MODULUS;
+            }
+        }
+    }
+
+    /**
+     * @return cyclic convolution of left and right modulo the prime, padded to size
+     * @note a square takes one forward transform instead of two
+     */
+    template <size_t PRIME_INDEX>
+    std::vector<uint64_t> convolution(const std::vector<int64_t>& left, const std::vector<int64_t>& right, size_t size) {
+        constexpr auto MODULUS = NTT_PRIMES[PRIME_INDEX].modulus;
+        const bool square = &left == &right;
+
+        std::vector<uint64_t> a(size, 0);
+        for (size_t i = 0; i < left.size(); i++) {
+            a[i] = static_cast<uint64_t>(left[i]) % MODULUS;
+        }
+        ntt<PRIME_INDEX>(a, false);
+
+        if (square) {
+            for (size_t i = 0; i < size; i++) {
+                a[i] = a[i] * a[i] % MODULUS;
+            }
+        } else {
+            std::vector<uint64_t> b(size, 0);
+            for (size_t i = 0; i < right.size(); i++) {
+                b[i] = static_cast<uint64_t>(right[i]) % MODULUS;
+            }
+            ntt<PRIME_INDEX>(b, false);
+            for (size_t i = 0; i < size; i++) {
+                a[i] = a[i] * b[i] % MODULUS;
+            }
+        }
+        ntt<PRIME_INDEX>(a, true);
+
+        return a;
+    }
+
+    using Convolution = std::vector<uint64_t> (*)(const std::vector<int64_t>&, const std::vector<int64_t>&, size_t);
+
+    constexpr std::array<Convolution, NTT_PRIMES.size()> CONVOLUTIONS = {
+            convolution<0>, convolution<1>, convolution<2>, convolution<3>, convolution<4>, convolution<5>
+    };
+
+    // signed and unsigned variants of a type may alias each other, so coefficients are reinterpreted in place
+    const word* asWords(const int64_t* coefs) {
+        return reinterpret_cast<const word*>(coefs);
+    }
+
+    word* asWords(int64_t* coefs) {
+        return reinterpret_cast<word*>(coefs);
+    }
+} // namespace
+
+std::vector<int64_t> schoolbookMultiply(const std::vector<int64_t>& left, const std::vector<int64_t>& right) {
+    std::vector<int64_t> result(left.size() + right.size() - 1);
+    schoolbookMultiply(left.data(), left.size(), right.data(), right.size(), result.data());
+    return result;
+}
+
+void schoolbookMultiply(const int64_t* left, size_t n, const int64_t* right, size_t m, int64_t* out) {
+    std::fill(out, out + n + m - 1, 0);
+    schoolbookInto(asWords(left), n, asWords(right), m, asWords(out));
+}
+
+void schoolbookMultiplyMod(const int64_t* left, size_t n, const int64_t* right, size_t m, uint64_t modulus, int64_t* out) {
+    using wide = unsigned __int128;
+    const auto* a = asWords(left);
+    const auto* b = asWords(right);
+    // 2^128 mod modulus, taken for every carry out of the 128-bit sum
+    const auto wrap = static_cast<uint64_t>((~wide{0}) % modulus + 1) % modulus;
+
+    for (size_t k = 0; k + 1 < n + m; k++) {
+        wide sum = 0;
+        uint64_t carries = 0;
+        const size_t first = k >= m ? k - m + 1 : 0;
+        const size_t last = std::min(k, n - 1);
+        for (size_t i = first; i <= last; i++) {
+            const auto previous = sum;
+            sum += static_cast<wide>(a[i]) * b[k - i];
+            carries += sum < previous;
+        }
+        const auto reduced = static_cast<uint64_t>(sum % modulus);
+        const auto overflow = mulMod(carries % modulus, wrap, modulus);
+        out[k] = static_cast<int64_t>(reduced >= modulus - overflow ? reduced - (modulus - overflow) : reduced + overflow);
+    }
+}
+
+std::vector<int64_t> karatsubaMultiply(const std::vector<int64_t>& left, const std::vector<int64_t>& right) {
+    std::vector<int64_t> result(left.size() + right.size() - 1);
+    karatsubaMultiply(left.data(), left.size(), right.data(), right.size(), result.data());
+    return result;
+}
+
+void karatsubaMultiply(const int64_t* left, size_t n, const int64_t* right, size_t m, int64_t* out) {
+    std::fill(out, out + n + m - 1, 0);
+    multiplyInto(asWords(left), n, asWords(right), m, asWords(out));
+}
+
+std::vector<int64_t> nttMultiply(const std::vector<int64_t>& left, const std::vector<int64_t>& right, uint64_t modulus) {
+    const size_t length = left.size() + right.size() - 1;
+
+    if (length > NTT_MAX_LENGTH) {
+        return nttMultiplyBlocks(left, right, modulus, NTT_MAX_LENGTH / 2);
+    }
+
+    size_t size = 1;
+    while (size < length) {
+        size <<= 1;
+    }
+
+    // every coefficient of the exact product is below min(n, m) * (modulus - 1)^2,
+    // so take primes until their product exceeds that bound
+    const double bound_bits = std::log2(static_cast<double>(std::min(left.size(), right.size())))
+                              + 2 * std::log2(static_cast<double>(modulus)) + 1;
+    size_t primes_count = 0;
+    double primes_bits = 0;
+    while (primes_bits <= bound_bits) {
+        primes_bits += std::log2(static_cast<double>(NTT_PRIMES[primes_count].modulus));
+        primes_count++;
+    }
+
+    std::array<std::vector<uint64_t>, NTT_PRIMES.size()> residues;
+    for (size_t k = 0; k < primes_count; k++) {
+        residues[k] = CONVOLUTIONS[k](left, right, size);
+    }
+
+    // Garner's algorithm: x = v_0 + v_1 * m_0 + v_2 * m_0 * m_1 + ...
+    // prefix[k][j] = m_0 * ... * m_{j-1} mod m_k, the last row is taken modulo the target modulus
+    std::array<std::array<uint64_t, NTT_PRIMES.size()>, NTT_PRIMES.size() + 1> prefix{};
+    std::array<uint64_t, NTT_PRIMES.size()> prefix_inverse{};
+    std::array<BarrettReducer, NTT_PRIMES.size()> reducers{};
+    for (size_t k = 0; k <= primes_count; k++) {
+        const auto current = k < primes_count ? NTT_PRIMES[k].modulus : modulus;
+        prefix[k][0] = 1 % current;
+        for (size_t j = 1; j <= k && j < primes_count; j++) {
+            prefix[k][j] = mulMod(prefix[k][j - 1], NTT_PRIMES[j - 1].modulus % current, current);
+        }
+        if (k < primes_count) {
+            prefix_inverse[k] = powMod(prefix[k][k], current - 2, current);
+            reducers[k] = BarrettReducer{current};
+        }
+    }
+
+    // the moduli are only known at run time, so every reduction goes through a precomputed Barrett reducer
+    // instead of a hardware division
+    // digits are below 2^31 and the last row below 2^64, so the terms are summed exactly in 128 bits and
+    // reduced modulo the target once per coefficient
+    std::vector<int64_t> result(length);
+    std::array<uint64_t, NTT_PRIMES.size()> digits{};
+    for (size_t i = 0; i < length; i++) {
+        unsigned __int128 value = 0;
+        for (size_t k = 0; k < primes_count; k++) {
+            const auto current = NTT_PRIMES[k].modulus;
+            const auto& reducer = reducers[k];
+            uint64_t accumulated = 0;
+            for (size_t j = 0; j < k; j++) {
+                accumulated = reducer.reduce(accumulated + digits[j] * prefix[k][j]);
+            }
+            digits[k] = reducer.reduce(reducer.reduce(residues[k][i] + current - accumulated) * prefix_inverse[k]);
+            value += static_cast<unsigned __int128>(digits[k]) * prefix[primes_count][k];
+        }
+        result[i] = static_cast<int64_t>(value % modulus);
+    }
+
+    return result;
+}
+
+std::vector<int64_t> nttMultiplyBlocks(const std::vector<int64_t>& left, const std::vector<int64_t>& right, uint64_t modulus,
+                                       size_t block) {
+    assert(block > 0 && block <= NTT_MAX_LENGTH / 2);
+    std::vector<int64_t> result(left.size() + right.size() - 1, 0);
+
+    // every pair of blocks gives a product of at most 2 * block - 1 coefficients, which fits a single transform
+    for (size_t i = 0; i < left.size(); i += block) {
+        const std::vector<int64_t> left_block(left.begin() + i, left.begin() + std::min(i + block, left.size()));
+        for (size_t j = 0; j < right.size(); j += block) {
+            const std::vector<int64_t> right_block(right.begin() + j, right.begin() + std::min(j + block, right.size()));
+            const auto partial = nttMultiply(left_block, right_block, modulus);
+            for (size_t k = 0; k < partial.size(); k++) {
+                // both summands are below modulus, which may be close to 2^64
+                const auto sum = static_cast<uint64_t>(result[i + j + k]);
+                const auto term = static_cast<uint64_t>(partial[k]);
+                result[i + j + k] = static_cast<int64_t>(sum >= modulus - term ? sum - (modulus - term) : sum + term);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace lab::detail
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lab::detail {
+
+/**
+ * @brief the smallest length of both operands for which Karatsuba is used instead of schoolbook
+ */
+inline constexpr size_t KARATSUBA_THRESHOLD = 32;
+
+/**
+ * @brief multiplies coefficient vectors in O(n*m)
+ */
+std::vector<int64_t> schoolbookMultiply(const std::vector<int64_t>& left, const std::vector<int64_t>& right);
+
+/**
+ * @brief writes the product of n coefficients of left and m coefficients of right into n + m - 1 coefficients of out
+ */
+void schoolbookMultiply(const int64_t* left, size_t n, const int64_t* right, size_t m, int64_t* out);
+
+/**
+ * @brief multiplies coefficient vectors in O(n^1.58) falling back to schoolbook for short pieces
+ * @note result coincides with schoolbookMultiply, including integer wrap-around
+ */
+std::vector<int64_t> karatsubaMultiply(const std::vector<int64_t>& left, const std::vector<int64_t>& right);
+
+/**
+ * @brief writes the product of n coefficients of left and m coefficients of right into n + m - 1 coefficients of out
+ */
+void karatsubaMultiply(const int64_t* left, size_t n, const int64_t* right, size_t m, int64_t* out);
+
+/**
+ * @brief writes the product of n coefficients of left and m coefficients of right modulo modulus into out
+ * @note coefficients must lie in [0, modulus); every coefficient of the product is summed exactly in 128 bits
+ *       and reduced once, which beats NTT on short operands when the modulus is too large for int64 products
+ */
+void schoolbookMultiplyMod(const int64_t* left, size_t n, const int64_t* right, size_t m, uint64_t modulus, int64_t* out);
+
+/**
+ * @brief the largest length of the shorter operand for which schoolbookMultiplyMod is used instead of NTT
+ */
+inline constexpr size_t MODULAR_SCHOOLBOOK_THRESHOLD = 256;
+
+/**
+ * @brief the smallest length of both operands for which modular products go through NTT
+ */
+inline constexpr size_t NTT_THRESHOLD = 1024;
+
+/**
+ * @brief the longest product (in coefficients) that fits the transform length of every NTT prime
+ */
+inline constexpr size_t NTT_MAX_LENGTH = size_t{1} << 23;
+
+/**
+ * @brief multiplies coefficient vectors modulo any modulus in O(n*log(n))
+ * @note coefficients must lie in [0, modulus); the product is computed by number-theoretic transforms
+ *       over several NTT-friendly primes and recombined with Garner's CRT, so the result is exact
+ *       for every 64-bit modulus; products longer than NTT_MAX_LENGTH are split by nttMultiplyBlocks;
+ *       passing the same vector as both operands squares it with one forward transform per prime
+ * @return coefficients of the product reduced to [0, modulus)
+ */
+std::vector<int64_t> nttMultiply(const std::vector<int64_t>& left, const std::vector<int64_t>& right, uint64_t modulus);
+
+/**
+ * @brief multiplies coefficient vectors modulo modulus by nttMultiply on every pair of blocks of at most block
+ *        coefficients, adding the partial products modulo modulus
+ * @note nttMultiply goes through it for products longer than NTT_MAX_LENGTH; block should be positive
+ *       and at most NTT_MAX_LENGTH / 2
+ */
+std::vector<int64_t> nttMultiplyBlocks(const std::vector<int64_t>& left, const std::vector<int64_t>& right, uint64_t modulus,
+                                       size_t block);
+
+} // namespace lab::detail
@@ -1,6 +1,8 @@
 #include "Polynomial.hpp"
+#include "Multiplication.hpp"
 
 #include <algorithm>
+#include <array>
 #include <utility>
 #include <cctype>
 
@@ -18,7 +20,15 @@ Polynomial::Polynomial(std::initializer_list<int64_t> coefs) : _coefs{coefs} {
     finalize();
 }
 
-Polynomial::Polynomial(std::vector<int64_t> coefs) : _coefs{coefs} {
+Polynomial::Polynomial(const std::vector<int64_t>& coefs) : _coefs(coefs.begin(), coefs.end()) {
+    if (_coefs.empty()) {
+        _coefs.push_back(0);
+    }
+
+    finalize();
+}
+
+Polynomial::Polynomial(storage_type coefs) : _coefs{std::move(coefs)} {
     if (_coefs.empty()) {
         _coefs.push_back(0);
     }
@@ -43,7 +53,7 @@ int64_t Polynomial::coefficient(size_t power) const {
 /**
  * @return the vector of coefficients
  */
-const std::vector<int64_t>& Polynomial::coefficients() const {
+const Polynomial::storage_type& Polynomial::coefficients() const {
     return _coefs;
 }
 
@@ -62,14 +72,22 @@ void Polynomial::finalize() {
 Polynomial Polynomial::modified(int64_t modulo) const {
     Polynomial result = *this;
 
-    for(auto& item : result._coefs) {
-        while (item < 0) {
-            item += modulo;
-        }
-        item = item % modulo;
+    for (auto& item : result._coefs) {
+        item %= modulo;
+        // the remainder takes the sign of the dividend, negative ones are shifted into [0, modulo)
+        item += modulo & (item >> 63);
     }
 
-        result.finalize();
+    result.finalize();
+
+    return result;
+}
+
+Polynomial Polynomial::modified(const detail::BarrettReducer& reducer) const {
+    Polynomial result = *this;
+
+    reducer.reduce(result._coefs.data(), result._coefs.size());
+    result.finalize();
 
     return result;
 }
@@ -135,12 +153,12 @@ Polynomial operator-(const Polynomial &left, const Polynomial &right) {
 
 Polynomial operator*(const Polynomial &left, const Polynomial &right) {
     Polynomial result{};
-    result._coefs = std::vector<int64_t>(left.degree() + right.degree() + 1, 0);
+    result._coefs.resize(left._coefs.size() + right._coefs.size() - 1);
 
-    for (unsigned i = 0; i <= left.degree(); i++) {
-        for (unsigned j = 0; j <= right.degree(); j++) {
-            result._coefs[i + j] += left.coefficient(i) * right.coefficient(j);
-        }
+    if (std::min(left.degree(), right.degree()) < detail::KARATSUBA_THRESHOLD) {
+        detail::schoolbookMultiply(left._coefs.data(), left._coefs.size(), right._coefs.data(), right._coefs.size(), result._coefs.data());
+    } else {
+        detail::karatsubaMultiply(left._coefs.data(), left._coefs.size(), right._coefs.data(), right._coefs.size(), result._coefs.data());
     }
 
     result.finalize();
@@ -165,10 +183,11 @@ Polynomial operator*(int64_t left, const Polynomial &right) {
 }
 
 Polynomial Polynomial::x(size_t power) {
-    std::vector<int64_t> coefs(power, 0);
-    coefs.push_back(1);
+    Polynomial result{};
+    result._coefs.resize(power + 1, 0);
+    result._coefs[power] = 1;
 
-    return Polynomial{coefs};
+    return result;
 }
 
 /**
@@ -372,3 +391,39 @@ std::optional<Polynomial> Polynomial::from_string(std::string str) {
 }
 
 } // namespace lab
+
+size_t std::hash<lab::Polynomial>::operator()(const lab::Polynomial& polynomial) const noexcept {
+    constexpr uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ull;
+    const auto& coefs = polynomial.coefficients();
+    const size_t size = coefs.size();
+
+    // four independent lanes without cross-iteration dependencies between them, so the main loop vectorizes
+    std::array<uint64_t, 4> lanes = {
+            0x243f6a8885a308d3ull, 0x13198a2e03707344ull, 0xa4093822299f31d0ull, 0x082efa98ec4e6c89ull
+    };
+    size_t i = 0;
+    for (; i + lanes.size() <= size; i += lanes.size()) {
+        for (size_t lane = 0; lane < lanes.size(); lane++) {
+            const auto mixed = (lanes[lane] ^ static_cast<uint64_t>(coefs[i + lane])) * MULTIPLIER;
+            lanes[lane] = (mixed << 31) | (mixed >> 33);
+        }
+    }
+    for (size_t lane = 0; i < size; i++, lane++) {
+        const auto mixed = (lanes[lane] ^ static_cast<uint64_t>(coefs[i])) * MULTIPLIER;
+        lanes[lane] = (mixed << 31) | (mixed >> 33);
+    }
+
+    uint64_t hash = size * MULTIPLIER;
+    for (const auto lane : lanes) {
+        hash = (hash ^ lane) * 0xff51afd7ed558ccdull;
+        hash ^= hash >> 32;
+    }
+
+    // final avalanche of MurmurHash3, so that the low bits depend on every coefficient
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return static_cast<size_t>(hash);
+}
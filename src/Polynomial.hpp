@@ -1,5 +1,10 @@
 #pragma once
 
+#include "SmallVector.hpp"
+#include "ModularArithmetic.hpp"
+
+#include <cstddef>
+#include <functional>
 #include <optional>
 #include <vector>
 #include <string>
@@ -13,8 +18,14 @@ class Polynomial {
 public:
     using coefficient_type = int64_t;
 
+    // polynomials of degree below INLINE_COEFFICIENTS keep their coefficients without heap allocations
+    static inline constexpr size_t INLINE_COEFFICIENTS = 16;
+
+    using storage_type = detail::SmallVector<coefficient_type, INLINE_COEFFICIENTS>;
+
     Polynomial();
-    Polynomial(std::vector<coefficient_type> coefs);
+    Polynomial(const std::vector<coefficient_type>& coefs);
+    Polynomial(storage_type coefs);
     Polynomial(std::initializer_list<coefficient_type> coefs);
 
     Polynomial(const Polynomial& that) = default;
@@ -40,6 +51,12 @@ public:
     [[nodiscard]]
     Polynomial modified(int64_t modulo) const;
 
+    /**
+     * @brief calculates all coefficients by modulo of the reducer in a single branch-free pass
+     */
+    [[nodiscard]]
+    Polynomial modified(const detail::BarrettReducer& reducer) const;
+
     /**
      * @brief calculates all coefficients by modulo
      */
@@ -50,7 +67,7 @@ public:
      * @return the vector of coefficients
      */
     [[nodiscard]]
-    const std::vector<coefficient_type>& coefficients() const;
+    const storage_type& coefficients() const;
 
     static std::optional<Polynomial> from_string(std::string str);
 
@@ -85,7 +102,7 @@ public:
 
 private:
     // Array of polynomial's coefficients
-    std::vector<int64_t> _coefs;
+    storage_type _coefs;
 
     /**
      * @brief removes extra 0 from back of coefficients vector
@@ -106,3 +123,15 @@ inline OStream& operator<<(OStream& os, const Polynomial& polynomial)
 }
 
 } // namespace lab
+
+namespace std {
+
+/**
+ * @brief hash over all coefficients, consistent with operator==
+ */
+template <>
+struct hash<lab::Polynomial> {
+    size_t operator()(const lab::Polynomial& polynomial) const noexcept;
+};
+
+} // namespace std
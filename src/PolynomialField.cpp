@@ -1,54 +1,135 @@
 #include "PolynomialField.hpp"
 #include "FieldMultiplicationCache.hpp"
+#include "ModularArithmetic.hpp"
+#include "Utils.hpp"
 
 #include <cassert>
+#include <stdexcept>
+#include <cstdint>
 #include <cmath>
 #include <optional>
 #include <numeric>
 #include <algorithm>
+#include <array>
+#include <thread>
 
 namespace lab {
 
+PolynomialField::ElementRange::iterator::iterator(const ElementRange& range, uint64_t index) :
+        _p{range._p},
+        _n{range._n},
+        _index{index} {}
+
+Polynomial PolynomialField::ElementRange::iterator::operator*() const {
+    return _element(_p, _n, _index);
+}
+
+PolynomialField::ElementRange::iterator& PolynomialField::ElementRange::iterator::operator++() {
+    ++_index;
+    return *this;
+}
+
+PolynomialField::ElementRange::iterator PolynomialField::ElementRange::iterator::operator++(int) {
+    auto copy = *this;
+    ++_index;
+    return copy;
+}
+
+uint64_t PolynomialField::ElementRange::iterator::index() const {
+    return _index;
+}
+
+bool PolynomialField::ElementRange::iterator::operator==(const iterator& that) const {
+    return _index == that._index;
+}
+
+bool PolynomialField::ElementRange::iterator::operator!=(const iterator& that) const {
+    return !(*this == that);
+}
+
+PolynomialField::ElementRange::ElementRange(uint64_t p, uint64_t n, uint64_t size) :
+        _p{p},
+        _n{n},
+        _size{size} {}
+
+uint64_t PolynomialField::ElementRange::size() const {
+    return _size;
+}
+
+Polynomial PolynomialField::ElementRange::operator[](uint64_t index) const {
+    return _element(_p, _n, index);
+}
+
+Polynomial PolynomialField::ElementRange::_element(uint64_t p, uint64_t n, uint64_t index) {
+    std::vector<int64_t> coefs(n);
+    for (auto& coef : coefs) {
+        coef = static_cast<int64_t>(index % p);
+        index /= p;
+    }
+    return Polynomial{coefs};
+}
+
+uint64_t PolynomialField::ElementRange::indexOf(const Polynomial& element) const {
+    const auto reduced = element.modified(_p);
+    assert(reduced.degree() < _n && "polynomial is not in the field");
+
+    uint64_t index = 0;
+    for (auto power = static_cast<int64_t>(reduced.degree()); power >= 0; power--) {
+        index = index * _p + reduced.coefficient(power);
+    }
+    return index;
+}
+
+PolynomialField::ElementRange::iterator PolynomialField::ElementRange::begin() const {
+    return iterator{*this, 0};
+}
+
+PolynomialField::ElementRange::iterator PolynomialField::ElementRange::end() const {
+    return iterator{*this, _size};
+}
+
 PolynomialField::PolynomialField(uint64_t p, const Polynomial &irreducible) :
         PolynomialRing{p},
         _n{irreducible.degree()},
+        _q{1},
         _irreducible{irreducible} {
-    _generateElements();
+    for (uint64_t i = 0; i < _n; i++) {
+        if (_q > UINT64_MAX / p) {
+            throw std::invalid_argument("field is too large: p^n does not fit into 64 bits");
+        }
+        _q *= p;
+    }
 
-    auto irreducible_coefs = _irreducible.coefficients();
-    irreducible_coefs.pop_back();
-    _from_irreducible = -1 * Polynomial{irreducible_coefs};
-}
+    _createReductionTable();
 
-void PolynomialField::_generateElements() {
-    _elements.reserve(std::pow(getP(), _n));
-    for (int64_t i = 0; i < getP(); i++) {
-        _elements.push_back(Polynomial{i});
+    _packed_reduction.resize(_n);
+    for (uint64_t j = 0; j < _n; j++) {
+        const auto coef = static_cast<uint64_t>(_irreducible.modified(p).coefficient(j));
+        _packed_reduction[j] = (p - coef) % p;
     }
 
-    std::vector<Polynomial> tmp;
-    for (int64_t n = _n - 2; n >= 0; n--) {
-        tmp = std::move(_elements);
-        _elements.clear();
-        for (const auto& item : tmp) {
-            for (int64_t j = 0; j < getP(); j++) {
-                _elements.push_back(item * Polynomial::x(1) + Polynomial{j});
-            }
+    if (p == 2) {
+        for (uint64_t j = 0; j <= _n; j++) {
+            _binary_irreducible |= static_cast<uint64_t>(_irreducible.modified(2).coefficient(j)) << j;
         }
     }
 }
 
 /*
- * @return elements of field
+ * @return lazy range of elements of field
  */
-const std::vector<Polynomial>& PolynomialField::elements() const {
-    return _elements;
+PolynomialField::ElementRange PolynomialField::elements() const {
+    return ElementRange{getP(), _n, _q};
 }
 
 uint64_t PolynomialField::getN() const {
     return _n;
 }
 
+uint64_t PolynomialField::getQ() const {
+    return _q;
+}
+
 const Polynomial& PolynomialField::getIrreducible() const {
     return _irreducible;
 }
@@ -62,81 +143,267 @@ namespace utils{
 Polynomial PolynomialField::add(const Polynomial &left, const Polynomial &right) const {
     utils::assert_(left, _n);
     utils::assert_(right, _n);
-    return (left + right).modified(getP());
+    return (left + right).modified(reducer());
 }
 
 Polynomial PolynomialField::subtract(const Polynomial &left, const Polynomial &right) const {
     utils::assert_(left, _n);
     utils::assert_(right, _n);
-    return (left - right).modified(getP());
+    return (left - right).modified(reducer());
+}
+
+/*
+ * @brief row 0 is -lc(f)^-1 * (f - lc(f) * x^n), every next row is the previous one multiplied by x and folded back by row 0
+ */
+void PolynomialField::_createReductionTable() {
+    const auto& reducer = this->reducer();
+    const auto p = getP();
+    const auto irreducible = _irreducible.modified(reducer);
+    const auto lead_inverse = _inverse(irreducible.coefficient(_n));
+
+    const auto rows = _n > 1 ? _n - 1 : 0;
+    _reduction_table.assign(std::max<uint64_t>(rows, 1) * _n, 0);
+    for (uint64_t j = 0; j < _n; j++) {
+        const auto coef = reducer.multiply(irreducible.coefficient(j), lead_inverse);
+        _reduction_table[j] = (p - coef) % p;
+        if (_reduction_table[j] != 0) {
+            _sparse_reduction.emplace_back(j, _reduction_table[j]);
+        }
+    }
+
+    // rows beyond x^n are of no use for sparse moduli
+    if (_sparse_reduction.size() <= SPARSE_MODULUS_MAX_TERMS) {
+        _reduction_table.resize(_n);
+        return;
+    }
+    _sparse_reduction.clear();
+
+    for (uint64_t k = 1; k < rows; k++) {
+        const auto* previous = &_reduction_table[(k - 1) * _n];
+        auto* row = &_reduction_table[k * _n];
+        const auto top = previous[_n - 1];
+        for (uint64_t j = 0; j < _n; j++) {
+            const auto shifted = j > 0 ? previous[j - 1] : 0;
+            row[j] = reducer.reduce(shifted + reducer.multiply(top, _reduction_table[j]));
+        }
+    }
+
+    // _reduceDegree sums n products of residues in 64 bits; a dense modulus has at least
+    // SPARSE_MODULUS_MAX_TERMS + 1 > 4 lower terms, so this follows from q = p^n fitting into 64 bits,
+    // but the accumulation must not depend on that argument silently
+    const auto max_residue = static_cast<unsigned __int128>(p - 1);
+    if (max_residue * max_residue * _n + max_residue > UINT64_MAX) {
+        throw std::invalid_argument("field is too large: n products of residues modulo p overflow 64 bits");
+    }
 }
 
-Polynomial PolynomialField::_reduceDegree(Polynomial polynomial) const {
-    while (polynomial.degree() >= _n) {
-            auto tmp = polynomial.coefficients().back() * Polynomial::x(polynomial.degree() - _n);
+/*
+ * @brief coefficients above x^(2n-2) are folded down one at a time, then x^n..x^(2n-2) are replaced
+ *        by rows of the reduction table in a single multiply-accumulate pass over the lower coefficients
+ */
+Polynomial PolynomialField::_reduceDegree(const Polynomial& polynomial) const {
+    const auto& reducer = this->reducer();
+    if (polynomial.degree() < _n) {
+        return polynomial.modified(reducer);
+    }
+
+    auto coefs = polynomial.coefficients();
+    reducer.reduce(coefs.data(), coefs.size());
+    if (hasSparseModulus()) {
+        return _reduceSparse(std::move(coefs));
+    }
 
-            auto polynomial_coefs = polynomial.coefficients();
-            polynomial_coefs.pop_back();
+    const auto p = static_cast<int64_t>(getP());
+    const auto* first_row = _reduction_table.data();
 
-            polynomial = Polynomial{ polynomial_coefs} + (_from_irreducible * tmp);
+    for (size_t power = coefs.size() - 1; power + 2 > 2 * _n; power--) {
+        const auto top = static_cast<uint64_t>(coefs[power]);
+        auto* target = &coefs[power - _n];
+        for (uint64_t j = 0; j < _n; j++) {
+            target[j] += static_cast<int64_t>(reducer.multiply(top, first_row[j]));
+            target[j] -= p & ((p - 1 - target[j]) >> 63);
+        }
     }
 
-    polynomial = polynomial.modified(getP());
+    // products are summed raw and every coefficient is reduced once at the end
+    const auto high_end = std::min<size_t>(coefs.size(), 2 * _n - 1);
+    for (size_t power = _n; power < high_end; power++) {
+        const auto top = static_cast<uint64_t>(coefs[power]);
+        const auto* row = &_reduction_table[(power - _n) * _n];
+        for (uint64_t j = 0; j < _n; j++) {
+            coefs[j] = static_cast<int64_t>(static_cast<uint64_t>(coefs[j]) + top * row[j]);
+        }
+    }
+    coefs.resize(_n);
+    for (auto& item : coefs) {
+        item = static_cast<int64_t>(reducer.reduce(static_cast<uint64_t>(item)));
+    }
 
-    return polynomial;
+    return Polynomial{std::move(coefs)};
+}
+
+Polynomial PolynomialField::_reduceSparse(Polynomial::storage_type coefs) const {
+    const auto& reducer = this->reducer();
+    const auto p = static_cast<int64_t>(getP());
+
+    for (size_t power = coefs.size() - 1; power >= _n; power--) {
+        const auto top = static_cast<uint64_t>(coefs[power]);
+        if (top == 0) {
+            continue;
+        }
+        auto* target = &coefs[power - _n];
+        for (const auto& [shift, coef] : _sparse_reduction) {
+            target[shift] += static_cast<int64_t>(reducer.multiply(top, coef));
+            target[shift] -= p & ((p - 1 - target[shift]) >> 63);
+        }
+    }
+
+    coefs.resize(_n);
+    return Polynomial{std::move(coefs)};
+}
+
+bool PolynomialField::hasSparseModulus() const {
+    return !_sparse_reduction.empty();
 }
 
 Polynomial PolynomialField::multiply(const Polynomial &left, const Polynomial &right) const {
     utils::assert_(left, _n);
     utils::assert_(right, _n);
 
+    if (_log_tables) {
+        return toPolynomial(multiply(toElement(left), toElement(right)));
+    }
+
     auto cached_result = detail::FieldMultiplicationCache::instance().getResult(getP(), _irreducible, left, right);
 
     if (cached_result.has_value()) {
         return cached_result.value();
     }
 
-    Polynomial result = (left * right).modified(getP());
-
-    result = _reduceDegree(result);
+    const auto result = _reduceDegree(PolynomialRing::multiply(left, right));
 
     detail::FieldMultiplicationCache::instance().setResult(getP(), _irreducible, left, right, result);
     return result;
 }
 
-Polynomial PolynomialField::_gcdExtended(const Polynomial& a, const Polynomial& b, Polynomial& x, Polynomial& y) const {
-    if (a == Polynomial({ 0 })) {
-        x = Polynomial({ 0 });
-        y = Polynomial({ 1 });
-        return b;
+/*
+ * @brief keeps remainders r0, r1 and cofactors s0, s1 with s * polynomial = r (mod irreducible),
+ *        every elimination of a leading coefficient of r0 updates s0 in the same pass
+ */
+Polynomial PolynomialField::_invertedByEuclid(const Polynomial& polynomial) const {
+    const auto& reducer = this->reducer();
+    const auto p = static_cast<int64_t>(getP());
+
+    Polynomial::storage_type buffers[4] = {
+            _irreducible.modified(reducer).coefficients(), polynomial.coefficients(),
+            Polynomial::storage_type(_n + 1, 0), Polynomial::storage_type(_n + 1, 0)
+    };
+    buffers[3][0] = 1;
+    auto* r0 = &buffers[0];
+    auto* r1 = &buffers[1];
+    auto* s0 = &buffers[2];
+    auto* s1 = &buffers[3];
+    size_t r0_size = r0->size();
+    size_t r1_size = r1->size();
+
+    while (r1_size > 1 || (*r1)[0] != 0) {
+        const auto lead_inverse = _inverse((*r1)[r1_size - 1]);
+        while (r0_size >= r1_size) {
+            const auto factor = reducer.multiply((*r0)[r0_size - 1], lead_inverse);
+            const auto offset = r0_size - r1_size;
+            for (size_t j = 0; j < r1_size; j++) {
+                auto& item = (*r0)[offset + j];
+                item -= static_cast<int64_t>(reducer.multiply((*r1)[j], factor));
+                item += p & (item >> 63);
+            }
+            // cofactors never reach degree n, so the shifted s1 fits
+            for (size_t j = 0; j + offset <= _n; j++) {
+                auto& item = (*s0)[offset + j];
+                item -= static_cast<int64_t>(reducer.multiply((*s1)[j], factor));
+                item += p & (item >> 63);
+            }
+            while (r0_size > 1 && (*r0)[r0_size - 1] == 0) {
+                r0_size--;
+            }
+            if (r0_size == 1 && (*r0)[0] == 0) {
+                break;
+            }
+        }
+        std::swap(r0, r1);
+        std::swap(r0_size, r1_size);
+        std::swap(s0, s1);
+    }
+
+    // r0 is now a non-zero constant c and s0 * polynomial = c
+    const auto normalizer = _inverse((*r0)[0]);
+    for (auto& item : *s0) {
+        item = static_cast<int64_t>(reducer.multiply(item, normalizer));
     }
+    return Polynomial{std::move(*s0)};
+}
 
-    Polynomial x1, y1;
-    const auto&[quotient, remainder] = div_mod(b, a);
-    Polynomial GCD = _gcdExtended(remainder, a, x1, y1);
+Polynomial PolynomialField::inverted(const Polynomial& polynomial) const {
+    const auto p = _reduceDegree(polynomial);
 
-    Polynomial tmp = _reduceDegree(PolynomialRing::multiply(quotient, x1));
-    x = subtract(y1, tmp);
-    y = x1;
+    if (_log_tables && p != Polynomial{0}) {
+        return toPolynomial(inverted(toElement(p)));
+    }
 
-    return GCD;
+    if (p == Polynomial{0}) {
+        return p;
+    }
+    return _invertedByEuclid(p);
 }
 
+std::vector<Polynomial> PolynomialField::invertMany(const std::vector<Polynomial>& polynomials) const {
+    std::vector<Polynomial> result;
+    result.reserve(polynomials.size());
 
+    if (_log_tables) {
+        for (const auto& polynomial : polynomials) {
+            result.push_back(inverted(polynomial));
+        }
+        return result;
+    }
 
-Polynomial PolynomialField::inverted(const Polynomial& polynomial) const {
-    Polynomial p, result, tmp, div;
-    p = _reduceDegree(polynomial);
+    // products bypass the multiplication cache, prefix products are never reused
+    const auto product = [this](const Polynomial& left, const Polynomial& right) {
+        return _reduceDegree(PolynomialRing::multiply(left, right));
+    };
+
+    // prefixes[i] is the product of all non-zero polynomials before the i-th one
+    std::vector<Polynomial> reduced;
+    std::vector<Polynomial> prefixes;
+    reduced.reserve(polynomials.size());
+    prefixes.reserve(polynomials.size());
+    Polynomial accumulated{1};
+    for (const auto& polynomial : polynomials) {
+        reduced.push_back(_reduceDegree(polynomial));
+        prefixes.push_back(accumulated);
+        if (reduced.back() != Polynomial{0}) {
+            accumulated = product(accumulated, reduced.back());
+        }
+    }
 
-    div = _gcdExtended(p, _irreducible, result, tmp);
-    if (div.coefficient(0) != 1) {
-        result = divide(result, Polynomial({ div.coefficient(0) }));
+    // walking backwards, inverse holds the inverse of the product of all non-zero polynomials up to the i-th one
+    auto inverse = _invertedByEuclid(accumulated);
+    result.resize(polynomials.size());
+    for (size_t i = polynomials.size(); i-- > 0;) {
+        if (reduced[i] == Polynomial{0}) {
+            result[i] = Polynomial{0};
+            continue;
+        }
+        result[i] = product(inverse, prefixes[i]);
+        inverse = product(inverse, reduced[i]);
     }
     return result;
 }
 
 
 Polynomial PolynomialField::pow(const Polynomial& poly, uint64_t power) const {
+    if (_log_tables) {
+        return toPolynomial(pow(toElement(poly), power));
+    }
     if (power == 1){
         return poly;
     }
@@ -147,32 +414,277 @@ Polynomial PolynomialField::pow(const Polynomial& poly, uint64_t power) const {
     return multiply(poly2, poly2);
 }
 
+PolynomialField::Element PolynomialField::toElement(const Polynomial& polynomial) const {
+    return Element{elements().indexOf(polynomial)};
+}
+
+Polynomial PolynomialField::toPolynomial(Element element) const {
+    return elements()[element.value()];
+}
+
+void PolynomialField::_unpack(Element element, uint64_t* digits) const {
+    auto value = element.value();
+    for (uint64_t i = 0; i < _n; i++) {
+        digits[i] = value % getP();
+        value /= getP();
+    }
+}
+
+PolynomialField::Element PolynomialField::_pack(const uint64_t* digits) const {
+    uint64_t value = 0;
+    for (auto i = static_cast<int64_t>(_n) - 1; i >= 0; i--) {
+        value = value * getP() + digits[i];
+    }
+    return Element{value};
+}
+
+uint64_t PolynomialField::_multiplyCoefficients(uint64_t left, uint64_t right) const {
+    // for n > 1 p is below 2^32, only prime fields can need a wide product
+    if (_n > 1) {
+        return left * right % getP();
+    }
+    return detail::mulMod(left, right, getP());
+}
+
+/*
+ * @brief carry-less multiplication of bit vectors followed by reduction by irreducible
+ */
+uint64_t PolynomialField::_multiplyBinary(uint64_t left, uint64_t right) const {
+    unsigned __int128 product = 0;
+    for (uint64_t i = 0; i < _n; i++) {
+        if ((right >> i) & 1) {
+            product ^= static_cast<unsigned __int128>(left) << i;
+        }
+    }
+
+    for (auto power = static_cast<int64_t>(2 * _n) - 2; power >= static_cast<int64_t>(_n); power--) {
+        if ((product >> power) & 1) {
+            product ^= static_cast<unsigned __int128>(_binary_irreducible) << (power - _n);
+        }
+    }
+
+    return static_cast<uint64_t>(product);
+}
+
+PolynomialField::Element PolynomialField::add(Element left, Element right) const {
+    if (getP() == 2) {
+        return Element{left.value() ^ right.value()};
+    }
+
+    std::array<uint64_t, MAX_PACKED_DEGREE> a{}, b{};
+    _unpack(left, a.data());
+    _unpack(right, b.data());
+    for (uint64_t i = 0; i < _n; i++) {
+        a[i] = a[i] >= getP() - b[i] ? a[i] - (getP() - b[i]) : a[i] + b[i];
+    }
+    return _pack(a.data());
+}
+
+PolynomialField::Element PolynomialField::subtract(Element left, Element right) const {
+    if (getP() == 2) {
+        return Element{left.value() ^ right.value()};
+    }
+
+    std::array<uint64_t, MAX_PACKED_DEGREE> a{}, b{};
+    _unpack(left, a.data());
+    _unpack(right, b.data());
+    for (uint64_t i = 0; i < _n; i++) {
+        a[i] = a[i] >= b[i] ? a[i] - b[i] : a[i] + (getP() - b[i]);
+    }
+    return _pack(a.data());
+}
+
+PolynomialField::Element PolynomialField::multiply(Element left, Element right) const {
+    if (_log_tables) {
+        if (left == Element{0} || right == Element{0}) {
+            return Element{0};
+        }
+        const auto& tables = *_log_tables;
+        return Element{tables.antilog[tables.log[left.value()] + tables.log[right.value()]]};
+    }
+
+    if (getP() == 2) {
+        return Element{_multiplyBinary(left.value(), right.value())};
+    }
+
+    std::array<uint64_t, MAX_PACKED_DEGREE> a{}, b{};
+    std::array<uint64_t, 2 * MAX_PACKED_DEGREE> product{};
+    _unpack(left, a.data());
+    _unpack(right, b.data());
+
+    for (uint64_t i = 0; i < _n; i++) {
+        if (a[i] == 0) {
+            continue;
+        }
+        for (uint64_t j = 0; j < _n; j++) {
+            product[i + j] = (product[i + j] + _multiplyCoefficients(a[i], b[j])) % getP();
+        }
+    }
+
+    // x^n = -f_{n-1} x^{n-1} - ... - f_0, applied from the highest power down
+    for (auto power = static_cast<int64_t>(2 * _n) - 2; power >= static_cast<int64_t>(_n); power--) {
+        const auto coef = product[power];
+        if (coef == 0) {
+            continue;
+        }
+        for (uint64_t j = 0; j < _n; j++) {
+            auto& target = product[power - _n + j];
+            target = (target + _multiplyCoefficients(coef, _packed_reduction[j])) % getP();
+        }
+    }
+
+    return _pack(product.data());
+}
+
+PolynomialField::Element PolynomialField::pow(Element element, uint64_t power) const {
+    if (_log_tables && element != Element{0}) {
+        const auto& tables = *_log_tables;
+        const auto exponent = detail::mulMod(tables.log[element.value()], power % (_q - 1), _q - 1);
+        return Element{tables.antilog[exponent]};
+    }
+
+    Element result{1};
+    while (power) {
+        if (power & 1) {
+            result = multiply(result, element);
+        }
+        element = multiply(element, element);
+        power >>= 1;
+    }
+    return result;
+}
+
+/*
+ * @note a^(q-2) = a^(-1) for every non-zero element of the field
+ */
+PolynomialField::Element PolynomialField::inverted(Element element) const {
+    assert(element != Element{0} && "zero is not invertible");
+    if (_log_tables) {
+        const auto& tables = *_log_tables;
+        return Element{tables.antilog[_q - 1 - tables.log[element.value()]]};
+    }
+    return pow(element, _q - 2);
+}
+
+const std::vector<uint64_t>& PolynomialField::_orderFactors() const {
+    std::call_once(_order_factors->once, [this]() {
+        auto& primes = _order_factors->primes;
+        primes = utils::get_divisors(_q - 1);
+        primes.erase(std::unique(primes.begin(), primes.end()), primes.end());
+    });
+    return _order_factors->primes;
+}
+
+bool PolynomialField::_isGenerator(Element element) const {
+    if (element == Element{0}) {
+        return false;
+    }
+    const auto& prime_factors = _orderFactors();
+    return std::all_of(prime_factors.begin(), prime_factors.end(), [&](const auto factor) {
+        return pow(element, (_q - 1) / factor) != Element{1};
+    });
+}
+
+PolynomialField::Element PolynomialField::_findGenerator() const {
+    for (uint64_t index = 1; index < _q; index++) {
+        if (_isGenerator(Element{index})) {
+            return Element{index};
+        }
+    }
+
+    assert(false && "field has no generator");
+    return Element{0};
+}
+
+bool PolynomialField::enableLogTables(uint64_t max_q) {
+    if (_log_tables) {
+        return true;
+    }
+    if (_q > std::min(max_q, LOG_TABLES_LIMIT)) {
+        return false;
+    }
+
+    auto tables = std::make_shared<LogTables>();
+    tables->generator = _findGenerator();
+    tables->log.assign(_q, 0);
+    tables->antilog.assign(2 * (_q - 1), 0);
+
+    // every thread starts from g^begin and walks its own chunk of powers;
+    // log gets written at distinct indices since g^i are all different
+    constexpr uint64_t MIN_CHUNK = 1 << 14;
+    const uint64_t order = _q - 1;
+    const uint64_t threads_count = std::clamp<uint64_t>(order / MIN_CHUNK, 1, std::max(1u, std::thread::hardware_concurrency()));
+    const uint64_t chunk = (order + threads_count - 1) / threads_count;
+
+    const auto fill = [this, &tables, order](uint64_t begin, uint64_t end) {
+        auto current = pow(tables->generator, begin);
+        for (uint64_t i = begin; i < end; i++) {
+            tables->antilog[i] = static_cast<uint32_t>(current.value());
+            tables->antilog[i + order] = static_cast<uint32_t>(current.value());
+            tables->log[current.value()] = static_cast<uint32_t>(i);
+            current = multiply(current, tables->generator);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (uint64_t begin = chunk; begin < order; begin += chunk) {
+        workers.emplace_back(fill, begin, std::min(order, begin + chunk));
+    }
+    fill(0, std::min(order, chunk));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    _log_tables = std::move(tables);
+    return true;
+}
+
+bool PolynomialField::hasLogTables() const {
+    return _log_tables != nullptr;
+}
+
+size_t PolynomialField::logTablesMemory() const {
+    if (!_log_tables) {
+        return 0;
+    }
+    return sizeof(LogTables)
+           + _log_tables->log.capacity() * sizeof(uint32_t)
+           + _log_tables->antilog.capacity() * sizeof(uint32_t);
+}
+
 /**
  * @brief checks if element is a field generator
  */
-bool PolynomialField:: isGenerator(const Polynomial &element) const {
+bool PolynomialField::isGenerator(const Polynomial &element) const {
     utils::assert_(element, _n);
 
-    auto polynomial = element;
-    auto power_counter = 1;
-
-    while (polynomial != Polynomial{1} && power_counter != _elements.size()) {
-        polynomial = multiply(polynomial, element);
-        power_counter++;
-    }
+    return _isGenerator(toElement(element));
+}
 
-    return power_counter == _elements.size() - 1;
+Polynomial PolynomialField::getGenerator() const {
+    return toPolynomial(_log_tables ? _log_tables->generator : _findGenerator());
 }
+
 /**
  * @return vector of field generators
  */
 std::vector<Polynomial> PolynomialField::getGenerators() const {
-    std::vector<Polynomial> result;
+    const auto generator = _log_tables ? _log_tables->generator : _findGenerator();
 
-    for (const auto& item : _elements) {
-        if (isGenerator(item)) {
-            result.push_back(item);
+    std::vector<Element> generators;
+    auto current = generator;
+    for (uint64_t power = 1; power < _q; power++) {
+        if (std::gcd(power, _q - 1) == 1) {
+            generators.push_back(current);
         }
+        current = multiply(current, generator);
+    }
+    std::sort(generators.begin(), generators.end());
+
+    std::vector<Polynomial> result;
+    result.reserve(generators.size());
+    for (const auto item : generators) {
+        result.push_back(toPolynomial(item));
     }
 
     return result;
@@ -2,6 +2,9 @@
 
 #include "Polynomial.hpp"
 #include "PolynomialRing.hpp"
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace lab {
@@ -12,22 +15,135 @@ namespace lab {
  */
 class PolynomialField : public PolynomialRing {
 public:
+    /**
+     * @brief lazy random-access range over all elements of a field
+     * @note element with index i has the base-p digits of i as coefficients (lowest digit is x^0),
+     *       so elements are produced on demand and nothing is stored
+     */
+    class ElementRange {
+    public:
+        /**
+         * @note dereferencing builds the element, so this is only an input iterator; use ElementRange::operator[]
+         *       for random access
+         */
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Polynomial;
+            using difference_type = int64_t;
+            using pointer = void;
+            using reference = Polynomial;
+
+            iterator(const ElementRange& range, uint64_t index);
+
+            Polynomial operator*() const;
+
+            iterator& operator++();
+            iterator operator++(int);
+
+            [[nodiscard]]
+            uint64_t index() const;
+
+            bool operator==(const iterator& that) const;
+            bool operator!=(const iterator& that) const;
+
+        private:
+            // range is kept by value: it is three integers, and iterators stay valid after the range is gone
+            uint64_t _p;
+            uint64_t _n;
+            uint64_t _index;
+        };
+
+        ElementRange(uint64_t p, uint64_t n, uint64_t size);
+
+        /**
+         * @return q = p^n
+         */
+        [[nodiscard]]
+        uint64_t size() const;
+
+        /**
+         * @return element with given base-p index
+         */
+        [[nodiscard]]
+        Polynomial operator[](uint64_t index) const;
+
+        /**
+         * @return base-p index of element, inverse of operator[]
+         */
+        [[nodiscard]]
+        uint64_t indexOf(const Polynomial& element) const;
+
+        [[nodiscard]]
+        iterator begin() const;
+
+        [[nodiscard]]
+        iterator end() const;
+
+    private:
+        uint64_t _p;
+        uint64_t _n;
+        uint64_t _size;
+
+        [[nodiscard]]
+        static Polynomial _element(uint64_t p, uint64_t n, uint64_t index);
+    };
+
+    /**
+     * @brief field element packed into one machine word
+     * @note value is the base-p index of the element (see ElementRange), for p = 2 it is the bit
+     *       vector of coefficients
+     */
+    class Element {
+    public:
+        Element() = default;
+
+        explicit Element(uint64_t value) : _value{value} {}
+
+        [[nodiscard]]
+        uint64_t value() const {
+            return _value;
+        }
+
+        friend bool operator==(Element left, Element right) {
+            return left._value == right._value;
+        }
+
+        friend bool operator!=(Element left, Element right) {
+            return left._value != right._value;
+        }
+
+        friend bool operator<(Element left, Element right) {
+            return left._value < right._value;
+        }
+
+    private:
+        uint64_t _value = 0;
+    };
+
     PolynomialField(const PolynomialField& that) = default;
 
     /**
      * @note irreducible polynomial should be normalized
+     * @throws std::invalid_argument if q = p^n does not fit into 64 bits
      */
     PolynomialField(uint64_t p, const Polynomial& irreducible);
 
     /**
-     * @return elements of field
+     * @return lazy range of elements of field
      */
     [[nodiscard]]
-    const std::vector<Polynomial>& elements() const;
+    ElementRange elements() const;
 
     [[nodiscard]]
     uint64_t getN() const;
 
+    /**
+     * @return count of elements q = p^n
+     */
+    [[nodiscard]]
+    uint64_t getQ() const;
+
     [[nodiscard]]
     const Polynomial& getIrreducible() const;
 
@@ -44,43 +160,189 @@ public:
     [[nodiscard]] 
     Polynomial inverted(const Polynomial& polynomial) const;
 
+    /**
+     * @return inverses of all polynomials, zero polynomials are mapped to zero
+     * @note Montgomery's trick: a single inversion plus 3(N-1) multiplications for N polynomials
+     */
+    [[nodiscard]]
+    std::vector<Polynomial> invertMany(const std::vector<Polynomial>& polynomials) const;
+
     [[nodiscard]]
     Polynomial pow(const Polynomial& num, uint64_t pow) const;
 
     [[nodiscard]]
     int64_t order_of_irreducible(const Polynomial& polynomial) const;
 
+    /**
+     * @return packed representation of field element
+     */
+    [[nodiscard]]
+    Element toElement(const Polynomial& polynomial) const;
+
+    /**
+     * @return polynomial representation of packed element
+     */
+    [[nodiscard]]
+    Polynomial toPolynomial(Element element) const;
+
+    [[nodiscard]]
+    Element add(Element left, Element right) const;
+
+    [[nodiscard]]
+    Element subtract(Element left, Element right) const;
+
+    /**
+     * @note works on stack buffers, no heap allocation takes place
+     */
+    [[nodiscard]]
+    Element multiply(Element left, Element right) const;
+
+    [[nodiscard]]
+    Element inverted(Element element) const;
+
+    [[nodiscard]]
+    Element pow(Element element, uint64_t power) const;
+
+    /**
+     * @brief the largest q for which discrete logarithm tables may be built
+     */
+    static inline constexpr uint64_t LOG_TABLES_LIMIT = uint64_t{1} << 20;
+
+    /**
+     * @brief builds discrete logarithm and antilogarithm tables from a field generator,
+     *        after that multiplication, inversion and powering are table lookups
+     * @param max_q opt-in threshold: tables are built only if q <= min(max_q, LOG_TABLES_LIMIT)
+     * @return true if tables are available after the call
+     * @note the tables are filled in parallel and shared between copies of the field
+     */
+    bool enableLogTables(uint64_t max_q = LOG_TABLES_LIMIT);
+
+    [[nodiscard]]
+    bool hasLogTables() const;
+
+    /**
+     * @return memory taken by discrete logarithm tables in bytes, 0 if they are not built
+     */
+    [[nodiscard]]
+    size_t logTablesMemory() const;
+
+    /**
+     * @brief irreducibles with at most this many non-zero terms below x^n are reduced by the sparse kernel
+     */
+    static inline constexpr size_t SPARSE_MODULUS_MAX_TERMS = 4;
+
+    /**
+     * @return true if products are reduced by the sparse kernel instead of the reduction table
+     */
+    [[nodiscard]]
+    bool hasSparseModulus() const;
+
     /**
      * @brief checks if element is a field generator
+     * @note element generates the multiplicative group iff element^((q-1)/r) != 1 for every prime r | q-1
      */
     [[nodiscard]]
     bool isGenerator(const Polynomial& element) const;
 
     /**
-     * @return vector of field generators
+     * @return the field generator with the smallest index
+     */
+    [[nodiscard]]
+    Polynomial getGenerator() const;
+
+    /**
+     * @return vector of field generators in the order of elements()
+     * @note all phi(q-1) generators are g^k with gcd(k, q-1) = 1 for any generator g
      */
     [[nodiscard]]
     std::vector<Polynomial> getGenerators() const;
 
 private:
-    void _generateElements();
-    
     /**
-     * @note gcd(a,b) = x*a + y*b
+     * @return inverse of a non-zero reduced polynomial by the iterative extended Euclidean algorithm
+     * @note runs in place on four coefficient buffers, which stay inline for small fields
      */
-    [[nodiscard]] 
-    Polynomial _gcdExtended(const Polynomial& a, const Polynomial& b, Polynomial& x, Polynomial& y) const;
+    [[nodiscard]]
+    Polynomial _invertedByEuclid(const Polynomial& polynomial) const;
 
     /**
      * @note transforms of any polynomial to polynomial which belongs to field
      */
     [[nodiscard]]
-    Polynomial _reduceDegree(Polynomial polynomial) const;
+    Polynomial _reduceDegree(const Polynomial& polynomial) const;
+
+    /**
+     * @throws std::invalid_argument if n products of residues modulo p do not fit into 64 bits
+     */
+    void _createReductionTable();
+
+    /**
+     * @brief reduces by a sparse irreducible, every coefficient above x^(n-1) is folded with a few shifted additions
+     */
+    [[nodiscard]]
+    Polynomial _reduceSparse(Polynomial::storage_type coefs) const;
+
+    // the largest n for which p^n may fit into 64 bits
+    static inline constexpr size_t MAX_PACKED_DEGREE = 64;
+
+    void _unpack(Element element, uint64_t* digits) const;
+
+    [[nodiscard]]
+    Element _pack(const uint64_t* digits) const;
+
+    [[nodiscard]]
+    uint64_t _multiplyCoefficients(uint64_t left, uint64_t right) const;
+
+    [[nodiscard]]
+    uint64_t _multiplyBinary(uint64_t left, uint64_t right) const;
+
+    /**
+     * @brief log[g^i] = i and antilog[i] = g^i for a generator g,
+     *        antilog is doubled in length so that sums of two logarithms need no reduction
+     */
+    struct LogTables {
+        Element generator;
+        std::vector<uint32_t> log;
+        std::vector<uint32_t> antilog;
+    };
+
+    /**
+     * @return the generator with the smallest index, found by checking g^((q-1)/r) != 1 for prime r | q-1
+     */
+    [[nodiscard]]
+    Element _findGenerator() const;
+
+    [[nodiscard]]
+    bool _isGenerator(Element element) const;
+
+    /**
+     * @brief distinct prime factors of q-1, found on the first request and shared between copies of the field
+     */
+    struct OrderFactors {
+        std::once_flag once;
+        std::vector<uint64_t> primes;
+    };
+
+    /**
+     * @return distinct prime factors of q-1 in increasing order
+     */
+    [[nodiscard]]
+    const std::vector<uint64_t>& _orderFactors() const;
 
     uint64_t _n;
+    uint64_t _q;
     Polynomial _irreducible;
-    Polynomial _from_irreducible;
-    std::vector<Polynomial> _elements;
+    // row k holds the n coefficients of x^(n+k) mod irreducible for k = 0..n-2, rows are stored one after another;
+    // only row 0 is kept for sparse moduli
+    std::vector<uint64_t> _reduction_table;
+    // non-zero terms (power, coefficient) of x^n mod irreducible when there are few of them, empty otherwise
+    std::vector<std::pair<uint64_t, uint64_t>> _sparse_reduction;
+    // -f_j mod p for the lower coefficients of irreducible f, used by packed multiplication
+    std::vector<uint64_t> _packed_reduction;
+    // bits of irreducible polynomial when p = 2
+    uint64_t _binary_irreducible = 0;
+    std::shared_ptr<const LogTables> _log_tables;
+    std::shared_ptr<OrderFactors> _order_factors = std::make_shared<OrderFactors>();
 };
 
 } // namespace lab
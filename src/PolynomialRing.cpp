@@ -1,78 +1,127 @@
 #include "PolynomialRing.hpp"
 #include "PolynomialField.hpp"
 #include "Utils.hpp"
+#include "Multiplication.hpp"
+#include "ModularArithmetic.hpp"
+#include "Factorization.hpp"
+#include "ModMatrix.hpp"
 
 #include <cmath>
 #include <cassert>
+#include <limits>
 #include <numeric>
 #include <algorithm>
+#include <functional>
+#include <random>
 
 namespace lab {
 
 
-namespace {
-    bool prime(const uint64_t &n) {
-        for (uint64_t i = 2; i <= sqrt(n); i++) {
-            if (n % i == 0) {
-                return false;
-            }
-        }
-        return true;
+uint64_t PolynomialRing::_divide_coefficients(uint64_t a, uint64_t b) const {
+    if (!_inverses.empty()) {
+        return a % _p * _inverses[b % _p] % _p;
     }
+    return detail::mulMod(a % _p, detail::inverseMod(b, _p), _p);
+}
 
-    int64_t modulusPow(int64_t number, uint64_t power, uint64_t modulus) {
-        if (power == 0) {
-            return 1;
-        }
-        int64_t temp = modulusPow(number, power / 2, modulus) % modulus;
-        int64_t result = 1;
-        if (power % 2 != 0) {
-            result = number % modulus;
-        }
-        return (temp * temp * result) % modulus;
+/*
+ * @return x such that a * x = 1 (mod p)
+ */
+uint64_t PolynomialRing::_inverse(uint64_t a) const {
+    if (!_inverses.empty()) {
+        return _inverses[a % _p];
     }
-} // namespace
-
-
-uint64_t PolynomialRing::_divide_coefficients(uint64_t a, uint64_t b) const {
-    return _dividing_table[a][b];
+    return detail::inverseMod(a, _p);
 }
 
-void PolynomialRing::_create_dividing_table(int field) {
-    _dividing_table.resize(field, std::vector<uint64_t>(field, 1));
-    for (int i = 1; i < field; i++) {
-        for (int j = 1; j < field; j++) {
-            int64_t res = (i * j) % field;
-            _dividing_table[res][i] = j;
-            _dividing_table[res][j] = i;
-        }
+/*
+ * @brief fills inverses of 1..p-1 in O(p) using inv(i) = -(p / i) * inv(p % i)
+ */
+void PolynomialRing::_create_inverses_table() {
+    _inverses.assign(_p, 0);
+    _inverses[1] = 1;
+    for (uint64_t i = 2; i < _p; i++) {
+        _inverses[i] = (_p - (_p / i) * _inverses[_p % i] % _p) % _p;
     }
 }
 
-PolynomialRing::PolynomialRing(uint64_t p) : _p{p} {
+PolynomialRing::PolynomialRing(uint64_t p)
+        : _p{p},
+          _reducer{p},
+          _max_exact_length{static_cast<size_t>(std::min<unsigned __int128>(
+                  std::numeric_limits<int64_t>::max() / (static_cast<unsigned __int128>(p - 1) * (p - 1)),
+                  std::numeric_limits<size_t>::max()))} {
 
-    assert(prime(p) && "p should be prime");
-    _create_dividing_table(p);
+    assert(detail::isPrime(p) && "p should be prime");
+    if (p <= INVERSE_TABLE_LIMIT) {
+        _create_inverses_table();
+    }
 }
 
 uint64_t PolynomialRing::getP() const {
     return _p;
 }
 
+const detail::BarrettReducer& PolynomialRing::reducer() const {
+    return _reducer;
+}
+
+/*
+ * @note operands are reduced first, so that sums of coefficients cannot overflow int64 even for p close to 2^63
+ */
 Polynomial PolynomialRing::add(const Polynomial &left, const Polynomial &right) const {
-    return (left + right).modified(_p);
+    const auto reduced_left = left.modified(_reducer);
+    const auto reduced_right = right.modified(_reducer);
+    Polynomial::storage_type result(std::max(reduced_left.degree(), reduced_right.degree()) + 1);
+    for (size_t i = 0; i < result.size(); i++) {
+        const auto sum = static_cast<uint64_t>(reduced_left.coefficient(i)) + static_cast<uint64_t>(reduced_right.coefficient(i));
+        result[i] = static_cast<int64_t>(sum >= _p ? sum - _p : sum);
+    }
+    return Polynomial{std::move(result)};
 }
 
 Polynomial PolynomialRing::subtract(const Polynomial &left, const Polynomial &right) const {
-    return (left - right).modified(_p);
+    const auto reduced_left = left.modified(_reducer);
+    const auto reduced_right = right.modified(_reducer);
+    Polynomial::storage_type result(std::max(reduced_left.degree(), reduced_right.degree()) + 1);
+    for (size_t i = 0; i < result.size(); i++) {
+        const auto difference = reduced_left.coefficient(i) - reduced_right.coefficient(i);
+        result[i] = difference + (static_cast<int64_t>(_p) & (difference >> 63));
+    }
+    return Polynomial{std::move(result)};
 }
 
 Polynomial PolynomialRing::multiply(const Polynomial &left, const Polynomial &right) const {
-    return (left * right).modified(_p);
+    const auto reduced_left = left.modified(_reducer);
+    const auto reduced_right = right.modified(_reducer);
+    const auto length = std::min(reduced_left.degree(), reduced_right.degree()) + 1;
+
+    // products which could overflow int64 go through NTT as well, it is exact for every modulus
+    if (length > detail::NTT_THRESHOLD || length > _max_exact_length) {
+        if (length <= detail::MODULAR_SCHOOLBOOK_THRESHOLD) {
+            const auto& left_coefs = reduced_left.coefficients();
+            const auto& right_coefs = reduced_right.coefficients();
+            Polynomial::storage_type result(left_coefs.size() + right_coefs.size() - 1);
+            detail::schoolbookMultiplyMod(left_coefs.data(), left_coefs.size(), right_coefs.data(), right_coefs.size(), _p, result.data());
+            return Polynomial{std::move(result)};
+        }
+        // a square passes the same vector twice, so nttMultiply transforms it only once
+        const std::vector<int64_t> left_coefs = reduced_left.coefficients();
+        if (&left == &right) {
+            return Polynomial{detail::nttMultiply(left_coefs, left_coefs, _p)};
+        }
+        return Polynomial{detail::nttMultiply(left_coefs, reduced_right.coefficients(), _p)};
+    }
+    return (reduced_left * reduced_right).modified(_reducer);
 }
 
 Polynomial PolynomialRing::multiply(const Polynomial &polynomial, const uint64_t &num) const {
-    return (polynomial * num).modified(_p);
+    auto result = polynomial.modified(_reducer).coefficients();
+    const auto factor = _reducer.reduce(num);
+    for (auto& item : result) {
+        item = static_cast<int64_t>(_reducer.multiply(static_cast<uint64_t>(item), factor));
+    }
+    return Polynomial{result};
 }
 
 Polynomial PolynomialRing::multiply(const uint64_t &num, const Polynomial &polynomial) const {
@@ -86,16 +135,20 @@ Polynomial PolynomialRing::multiply(const uint64_t &num, const Polynomial &polyn
 std::pair<Polynomial, Polynomial> PolynomialRing::div_mod(const Polynomial &left, const Polynomial &right) const {
 
     assert(right != Polynomial{0});
-    Polynomial divided = left.modified(_p);
-    Polynomial divisor = right.modified(_p);
+    Polynomial divided = left.modified(_reducer);
+    Polynomial divisor = right.modified(_reducer);
 
     const auto PolyLen = divisor.degree();
     const auto PolyDiff = divided.degree() - divisor.degree();
 
     if (divided.degree() < divisor.degree())
         return {Polynomial{0}, divided};
-    std::vector<int64_t> div(PolyDiff + 1);
-    std::vector<int64_t> mod;
+
+    if (std::min(PolyLen, PolyDiff) >= NEWTON_DIVISION_THRESHOLD) {
+        return _newton_div_mod(divided, divisor, _reversed_inverse(divisor, PolyDiff + 1));
+    }
+
+    Polynomial::storage_type div(PolyDiff + 1);
     auto rest = divided.coefficients();
 
 
@@ -109,15 +162,73 @@ std::pair<Polynomial, Polynomial> PolynomialRing::div_mod(const Polynomial &left
         uint64_t next_coefficient = _divide_coefficients(higher_divided, higher_divisor);
         div[i - divisor.degree()] = next_coefficient;
         for (int j = static_cast<int>(i); j >= i - divisor.degree() && j >= 0; j--) {
-            rest[j] = rest[j] - ((divisor.coefficient(PolyLen - (i - j)) * next_coefficient) % _p);
-            while (rest[j] < 0) {
-                rest[j] += _p;
-            }
+            const auto product = static_cast<int64_t>(_reducer.multiply(divisor.coefficient(PolyLen - (i - j)), next_coefficient));
+            rest[j] -= product;
+            rest[j] += static_cast<int64_t>(_p) & (rest[j] >> 63);
         }
         assert(rest[i] == 0 && "Division coefficients are incorrect");
     }
 
-    return {Polynomial{div}.modified(_p), Polynomial{rest}.modified(_p)};
+    return {Polynomial{div}, Polynomial{rest}};
+}
+
+namespace {
+    /**
+     * @return polynomial with coefficients of x^0..x^(length-1) taken in reverse order
+     */
+    Polynomial reversed(const Polynomial& polynomial, size_t length) {
+        Polynomial::storage_type coefs(length);
+        for (size_t i = 0; i < length; i++) {
+            coefs[i] = polynomial.coefficient(length - 1 - i);
+        }
+        return Polynomial{std::move(coefs)};
+    }
+
+    /**
+     * @return polynomial mod x^length
+     */
+    Polynomial truncated(const Polynomial& polynomial, size_t length) {
+        const auto& coefs = polynomial.coefficients();
+        if (coefs.size() <= length) {
+            return polynomial;
+        }
+        return Polynomial{Polynomial::storage_type(coefs.begin(), coefs.begin() + length)};
+    }
+} // namespace
+
+/*
+ * @brief Newton iteration g <- g * (2 - f * g), doubling the count of correct coefficients every step
+ */
+Polynomial PolynomialRing::_reversed_inverse(const Polynomial& divisor, size_t length) const {
+    const auto reversed_divisor = reversed(divisor, divisor.degree() + 1);
+    Polynomial inverse{static_cast<int64_t>(_inverse(reversed_divisor.coefficient(0)))};
+
+    // ring multiplication is called explicitly, since fields override it with reduction by the irreducible
+    for (size_t precision = 1; precision < length;) {
+        precision = std::min(2 * precision, length);
+        const auto error = truncated(PolynomialRing::multiply(truncated(reversed_divisor, precision), inverse), precision);
+        const auto correction = PolynomialRing::subtract(Polynomial{2}, error);
+        inverse = truncated(PolynomialRing::multiply(inverse, correction), precision);
+    }
+    return inverse;
+}
+
+/*
+ * @brief reversed quotient is rev(divided) / rev(divisor) mod x^(quotient length), the remainder is what is left
+ */
+std::pair<Polynomial, Polynomial> PolynomialRing::_newton_div_mod(const Polynomial& divided, const Polynomial& divisor,
+                                                                 const Polynomial& inverse) const {
+    if (divided.degree() < divisor.degree()) {
+        return {Polynomial{0}, divided};
+    }
+
+    const auto quotient_length = divided.degree() - divisor.degree() + 1;
+    const auto reversed_divided = truncated(reversed(divided, divided.degree() + 1), quotient_length);
+    const auto reversed_quotient = truncated(PolynomialRing::multiply(reversed_divided, truncated(inverse, quotient_length)), quotient_length);
+    const auto quotient = reversed(reversed_quotient, quotient_length);
+
+    const auto product = truncated(PolynomialRing::multiply(divisor, quotient), divisor.degree());
+    return {quotient, PolynomialRing::subtract(truncated(divided, divisor.degree()), product)};
 }
 
 /*
@@ -136,80 +247,257 @@ Polynomial PolynomialRing::mod(const Polynomial &left, const Polynomial &right)
 }
 
 Polynomial PolynomialRing::normalize(const Polynomial &polynomial) const {
-    Polynomial result(polynomial.modified(_p));
-    uint64_t normalizator = 1;
-    if (_p > 2) {
-        normalizator = modulusPow(polynomial.coefficient(polynomial.degree()), _p - 2, _p);
-    }
-    return (result * normalizator).modified(_p);
+    Polynomial result(polynomial.modified(_reducer));
+    const uint64_t normalizator = _inverse(result.coefficient(result.degree()));
+    return multiply(result, normalizator);
 }
 
 uint64_t PolynomialRing::evaluate(Polynomial &polynomial, uint64_t point) const {
-    polynomial = polynomial.modified(_p);
+    polynomial = polynomial.modified(_reducer);
+    point = _reducer.reduce(point);
+
+    // Horner's scheme keeps every intermediate value below p
     uint64_t result = 0;
-    int64_t point_power = 1;
-    for (size_t power = 0; power <= polynomial.degree(); ++power) {
-        result += (polynomial.coefficient(power) * point_power) % _p;
-        point_power *= point;
+    for (size_t power = polynomial.degree() + 1; power-- > 0;) {
+        result = _reducer.reduce(_reducer.multiply(result, point) + static_cast<uint64_t>(polynomial.coefficient(power)));
     }
-    result %= _p;
     return result;
 }
 
-Polynomial PolynomialRing::derivate(Polynomial &polynomial) const {
-    return polynomial.derivate().modified(_p);
+/*
+ * @note every term power * coef is formed modulo p, as the integer product overflows int64 for large p
+ */
+Polynomial PolynomialRing::derivate(const Polynomial &polynomial) const {
+    const auto reduced = polynomial.modified(_reducer);
+    const auto& coefs = reduced.coefficients();
+    if (coefs.size() <= 1) {
+        return Polynomial{0};
+    }
+    Polynomial::storage_type result(coefs.size() - 1);
+    for (size_t power = 1; power < coefs.size(); power++) {
+        result[power - 1] = static_cast<int64_t>(_reducer.multiply(_reducer.reduce(static_cast<uint64_t>(power)),
+                                                                   static_cast<uint64_t>(coefs[power])));
+    }
+    return Polynomial{std::move(result)};
 }
 
 Polynomial PolynomialRing::gcd(Polynomial left, Polynomial right) const {
     while (left != Polynomial{0} && right != Polynomial{0}) {
         left = mod(left, right);
         std::swap(left, right);
+        if (right == Polynomial{0}) {
+            break;
+        }
+
+        // from here deg left > deg right, and every later remainder is reduced
+        left = left.modified(_reducer);
+        if (right.degree() < HALF_GCD_THRESHOLD) {
+            return _euclid_gcd(left, right);
+        }
+
+        // half-GCD skips to the middle of the remainder sequence, so the result is the same as of plain Euclid
+        auto [next_left, next_right] = _apply(_half_gcd(left, right), left, right);
+        left = std::move(next_left);
+        right = std::move(next_right);
     }
     if (left == Polynomial{0})
         return right;
     return left;
 }
 
+Polynomial PolynomialRing::_euclid_gcd(const Polynomial& left, const Polynomial& right) const {
+    auto first = left.coefficients();
+    auto second = right.coefficients();
+    auto* a = &first;
+    auto* b = &second;
+    size_t a_size = a->size();
+    size_t b_size = b->size();
+    const auto p = static_cast<int64_t>(_p);
+
+    while (true) {
+        // a <- a mod b, eliminating the leading coefficients of a from the top
+        const auto lead_inverse = _inverse((*b)[b_size - 1]);
+        while (a_size >= b_size) {
+            const auto factor = _reducer.multiply((*a)[a_size - 1], lead_inverse);
+            const auto offset = a_size - b_size;
+            for (size_t j = 0; j < b_size; j++) {
+                auto& item = (*a)[offset + j];
+                item -= static_cast<int64_t>(_reducer.multiply((*b)[j], factor));
+                item += p & (item >> 63);
+            }
+            while (a_size > 0 && (*a)[a_size - 1] == 0) {
+                a_size--;
+            }
+        }
+
+        if (a_size == 0) {
+            b->resize(b_size);
+            return Polynomial{std::move(*b)};
+        }
+        std::swap(a, b);
+        std::swap(a_size, b_size);
+    }
+}
+
+namespace {
+    bool isZero(const Polynomial& polynomial) {
+        return polynomial.degree() == 0 && polynomial.coefficient(0) == 0;
+    }
+
+    /**
+     * @return polynomial divided by x^power, the remainder is dropped
+     */
+    Polynomial shifted(const Polynomial& polynomial, size_t power) {
+        const auto& coefs = polynomial.coefficients();
+        if (power >= coefs.size()) {
+            return Polynomial{0};
+        }
+        return Polynomial{Polynomial::storage_type(coefs.begin() + power, coefs.end())};
+    }
+} // namespace
+
+std::pair<Polynomial, Polynomial> PolynomialRing::_apply(const GcdMatrix& matrix, const Polynomial& a, const Polynomial& b) const {
+    return {PolynomialRing::add(PolynomialRing::multiply(matrix[0], a), PolynomialRing::multiply(matrix[1], b)),
+            PolynomialRing::add(PolynomialRing::multiply(matrix[2], a), PolynomialRing::multiply(matrix[3], b))};
+}
+
+PolynomialRing::GcdMatrix PolynomialRing::_compose(const GcdMatrix& left, const GcdMatrix& right) const {
+    const auto [m00, m10] = _apply(left, right[0], right[2]);
+    const auto [m01, m11] = _apply(left, right[1], right[3]);
+    return {m00, m01, m10, m11};
+}
+
+/*
+ * @brief the first half of quotients depends only on the upper halves of a and b, so it is found recursively from them
+ */
+PolynomialRing::GcdMatrix PolynomialRing::_half_gcd(const Polynomial& a, const Polynomial& b) const {
+    const size_t middle = (a.degree() + 1) / 2;
+    GcdMatrix result{Polynomial{1}, Polynomial{0}, Polynomial{0}, Polynomial{1}};
+    if (isZero(b) || b.degree() < middle) {
+        return result;
+    }
+
+    const auto step = [this, &result](const Polynomial& c, const Polynomial& d) {
+        auto [quotient, remainder] = div_mod(c, d);
+        result = _compose({Polynomial{0}, Polynomial{1}, Polynomial{1}, PolynomialRing::subtract(Polynomial{0}, quotient)}, result);
+        return std::move(remainder);
+    };
+
+    // short inputs are walked through quotient by quotient
+    if (a.degree() < HALF_GCD_BASE_DEGREE) {
+        Polynomial c = a;
+        Polynomial d = b;
+        while (!isZero(d) && d.degree() >= middle) {
+            auto remainder = step(c, d);
+            c = std::move(d);
+            d = std::move(remainder);
+        }
+        return result;
+    }
+
+    result = _half_gcd(shifted(a, middle), shifted(b, middle));
+    const auto [c, d] = _apply(result, a, b);
+    if (isZero(d) || d.degree() < middle) {
+        return result;
+    }
+
+    const auto e = step(c, d);
+    if (isZero(e) || e.degree() < middle) {
+        return result;
+    }
+
+    const auto shift = 2 * middle - d.degree();
+    return _compose(_half_gcd(shifted(d, shift), shifted(e, shift)), result);
+}
+
 Polynomial PolynomialRing::cyclotomicPolinomial(uint64_t order) const {
-    auto power = 1;
-    if (!order % _p) {
-        power = _p - 1;
-        order /= _p;
-        while (!order % _p) {
-            power *= _p;
-            order /= _p;
-        }
-    }
-    auto polynomial1 = Polynomial{1};
-    auto polynomial2 = Polynomial{1};
-    for (uint64_t i = 1; i <= static_cast<uint64_t>(sqrt(order)); i++) {
-        if (order % i == 0) {
-            std::vector<int64_t> poly1(i, 0);
-            poly1[0] = -1;
-            poly1.push_back(1);
-            auto pow = detail::moebiusFunction(order / i);
-            if (pow == 1) {
-                polynomial1 = multiply(polynomial1, poly1);
-            } else if (pow == -1) {
-                polynomial2 = multiply(polynomial2, poly1);
+    auto& cache = *_cyclotomic_cache;
+    {
+        std::lock_guard lock{cache.mutex};
+        if (const auto* cached = cache.entries.get(order)) {
+            return *cached;
+        }
+    }
+
+    auto result = _build_cyclotomic(order);
+
+    const auto memory = sizeof(order) + sizeof(Polynomial) + result.coefficients().capacity() * sizeof(int64_t);
+    if (memory <= CYCLOTOMIC_CACHE_BUDGET) {
+        std::lock_guard lock{cache.mutex};
+        if (const auto* cached = cache.entries.find(order)) {
+            cache.memory -= sizeof(order) + sizeof(Polynomial) + cached->coefficients().capacity() * sizeof(int64_t);
+        }
+        cache.entries.insert(order, result);
+        cache.memory += memory;
+        while (cache.memory > CYCLOTOMIC_CACHE_BUDGET) {
+            cache.memory -= sizeof(order) + sizeof(Polynomial) + cache.entries.back().coefficients().capacity() * sizeof(int64_t);
+            cache.entries.popBack();
+        }
+    }
+
+    return result;
+}
+
+size_t PolynomialRing::cyclotomicCacheMemory() const {
+    std::lock_guard lock{_cyclotomic_cache->mutex};
+    return _cyclotomic_cache->memory;
+}
+
+Polynomial PolynomialRing::_build_cyclotomic(uint64_t order) const {
+    assert(order > 0 && "order should be positive");
+
+    auto primes = detail::primeFactors(order);
+    primes.erase(std::unique(primes.begin(), primes.end()), primes.end());
+    const auto radical = std::accumulate(primes.begin(), primes.end(), uint64_t{1}, std::multiplies<>{});
+    const auto degree = std::accumulate(primes.begin(), primes.end(), uint64_t{1}, [](uint64_t product, uint64_t prime) {
+        return product * (prime - 1);
+    });
+
+    // Phi_radical is the product of (x^d - 1)^mu(radical / d) over divisors d of the radical and has degree
+    // phi(radical), so it is computed modulo x^(phi(radical) + 1), where x^d - 1 is a unit and every factor
+    // may be applied in any order; the buffer never outgrows the result
+    const auto length = degree + 1;
+    std::vector<int64_t> coefs(length, 0);
+    coefs[0] = 1;
+    const auto p = static_cast<int64_t>(_p);
+    const auto difference = [p](int64_t a, int64_t b) {
+        return a >= b ? a - b : a - b + p;
+    };
+
+    for (uint64_t subset = 0; subset < (uint64_t{1} << primes.size()); subset++) {
+        uint64_t d = 1;
+        size_t count = 0;
+        for (size_t i = 0; i < primes.size(); i++) {
+            if (subset >> i & 1) {
+                d *= primes[i];
+                count++;
             }
+        }
 
-            if (i * i != order) {
-                std::vector<int64_t> poly2(order / i, 0);
-                poly2[0] = -1;
-                poly2.push_back(1);
-                pow = detail::moebiusFunction(i);
-                if (pow == 1) {
-                    polynomial1 = multiply(polynomial1, poly2);
-                } else if (pow == -1) {
-                    polynomial2 = multiply(polynomial2, poly2);
-                }
+        if ((primes.size() - count) % 2 == 0) {
+            // (x^d - 1) * c: c[i] becomes c[i - d] - c[i], going down so that c[i - d] is still the old one
+            for (auto i = length; i-- > d;) {
+                coefs[i] = difference(coefs[i - d], coefs[i]);
+            }
+            for (uint64_t i = 0; i < std::min(d, length); i++) {
+                coefs[i] = difference(0, coefs[i]);
+            }
+        } else {
+            // c / (x^d - 1) = -c * (1 + x^d + x^(2d) + ...): the quotient q satisfies q[i] = q[i - d] - c[i], going up
+            for (uint64_t i = 0; i < length; i++) {
+                coefs[i] = difference(i >= d ? coefs[i - d] : 0, coefs[i]);
             }
         }
     }
-    if (power == 1)
-        return divide(polynomial1, polynomial2);
-    return pow(divide(polynomial1, polynomial2), static_cast<uint64_t>(power));
+
+    // Phi_n(x) = Phi_radical(x^(n / radical))
+    const auto stretch = order / radical;
+    Polynomial::storage_type result(degree * stretch + 1, 0);
+    for (uint64_t i = 0; i <= degree; i++) {
+        result[i * stretch] = coefs[i];
+    }
+
+    return Polynomial{std::move(result)};
 }
 
 Polynomial PolynomialRing::pow(const Polynomial &poly, uint64_t power) const {
@@ -223,6 +511,101 @@ Polynomial PolynomialRing::pow(const Polynomial &poly, uint64_t power) const {
     return multiply(poly2, poly2);
 }
 
+Polynomial PolynomialRing::powMod(const Polynomial &base, uint64_t power, const Polynomial &modulus) const {
+    auto result = mod(Polynomial{1}, modulus);
+    auto square = mod(base, modulus);
+
+    // products of reduced polynomials have quotients shorter than the modulus, so one inverse serves all reductions
+    const auto reduced_modulus = modulus.modified(_reducer);
+    const auto inverse = _product_inverse(reduced_modulus);
+    const auto reduce = [&](const Polynomial& polynomial) {
+        return _reduce_product(polynomial, reduced_modulus, inverse);
+    };
+
+    while (power) {
+        if (power & 1) {
+            result = reduce(multiply(result, square));
+        }
+        power >>= 1;
+        if (power) {
+            square = reduce(multiply(square, square));
+        }
+    }
+
+    return result;
+}
+
+Polynomial PolynomialRing::_product_inverse(const Polynomial& modulus) const {
+    const auto reduced = modulus.modified(_reducer);
+    return reduced.degree() >= NEWTON_DIVISION_THRESHOLD ? _reversed_inverse(reduced, reduced.degree()) : Polynomial{};
+}
+
+Polynomial PolynomialRing::_reduce_product(const Polynomial& product, const Polynomial& modulus, const Polynomial& inverse) const {
+    if (modulus.degree() >= NEWTON_DIVISION_THRESHOLD) {
+        const auto reduced = product.modified(_reducer);
+        if (reduced.degree() < modulus.degree()) {
+            return reduced;
+        }
+        return _newton_div_mod(reduced, modulus, inverse).second;
+    }
+    return mod(product, modulus);
+}
+
+std::vector<Polynomial> PolynomialRing::_composition_powers(const Polynomial& h, size_t count, const Polynomial& modulus,
+                                                             const Polynomial& inverse) const {
+    std::vector<Polynomial> powers{mod(Polynomial{1}, modulus), mod(h, modulus)};
+    while (powers.size() <= count) {
+        powers.push_back(_reduce_product(PolynomialRing::multiply(powers.back(), powers[1]), modulus, inverse));
+    }
+    powers.resize(count + 1);
+    return powers;
+}
+
+Polynomial PolynomialRing::_compose_mod(const Polynomial& g, const std::vector<Polynomial>& powers, const Polynomial& modulus,
+                                        const Polynomial& inverse) const {
+    const auto block = powers.size() - 1;
+    const auto reduced = g.modified(_reducer);
+    const auto& coefs = reduced.coefficients();
+    const auto width = modulus.degree();
+    const auto p = _p;
+
+    // sum of coefs[first + j] * h^j over the block, every term is reduced, so the sum only needs conditional subtraction
+    const auto combine = [&](size_t first) {
+        Polynomial::storage_type sum(width, 0);
+        for (size_t j = 0; j < block && first + j < coefs.size(); j++) {
+            const auto factor = static_cast<uint64_t>(coefs[first + j]);
+            if (factor == 0) {
+                continue;
+            }
+            const auto& power = powers[j].coefficients();
+            for (size_t t = 0; t < power.size() && t < width; t++) {
+                const auto term = _reducer.multiply(factor, static_cast<uint64_t>(power[t]));
+                const auto current = static_cast<uint64_t>(sum[t]);
+                sum[t] = static_cast<int64_t>(current >= p - term ? current - (p - term) : current + term);
+            }
+        }
+        return Polynomial{std::move(sum)};
+    };
+
+    auto first = (coefs.size() - 1) / block * block;
+    auto result = combine(first);
+    while (first > 0) {
+        first -= block;
+        result = add(_reduce_product(PolynomialRing::multiply(result, powers[block]), modulus, inverse), combine(first));
+    }
+    return result;
+}
+
+Polynomial PolynomialRing::composeMod(const Polynomial& g, const Polynomial& h, const Polynomial& modulus) const {
+    const auto reduced_modulus = modulus.modified(_reducer);
+    if (reduced_modulus.degree() == 0) {
+        return Polynomial{0};
+    }
+    const auto inverse = _product_inverse(reduced_modulus);
+    const auto block = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(g.degree() + 1))));
+    return _compose_mod(g, _composition_powers(h, block, reduced_modulus, inverse), reduced_modulus, inverse);
+}
+
 std::vector<Polynomial> PolynomialRing::cyclotomicFactorization(uint64_t order) const {
     uint64_t factor_degree = 1,
             tmp = getP(),
@@ -289,7 +672,7 @@ std::vector<Polynomial> PolynomialRing::cyclotomicFactorization(uint64_t order)
 
 std::vector<Polynomial> PolynomialRing::irreducibleOfOrder(uint64_t order) const {
     // expression = p^order - 1
-    std::vector<uint64_t> expression_divisors = detail::integerFactorization(std::pow(_p, order) - 1);
+    std::vector<uint64_t> expression_divisors = detail::integerFactorization(detail::integerPow(_p, order) - 1);
     std::vector<uint64_t> n_divisors = detail::integerFactorization(order);
 
     // needed numbers -- such m that p^order - 1 % m = 0 and p^t - 1 % m != 0 for each t < order
@@ -300,7 +683,7 @@ std::vector<Polynomial> PolynomialRing::irreducibleOfOrder(uint64_t order) const
         if (expression_divisor < 1000) {
             bool need = true;
             for (auto n_divisor : n_divisors) {
-                if ((uint64_t) std::pow(_p, n_divisor) % expression_divisor == 0) {
+                if (detail::powMod(_p, n_divisor, expression_divisor) == 0) {
                     need = false;
                 }
             }
@@ -332,24 +715,75 @@ bool PolynomialRing::isIrreducible(const Polynomial &polynomial) const {
     if (polynomial.degree() == 0)
         return false;
     auto f = normalize(polynomial);
+    const Polynomial x{0, 1};
+    // frobenius = x^(p^i) mod f
+    auto frobenius = mod(x, f);
     for (int i = 1; i <= f.degree() / 2; i++) {
-        auto g = subtract(Polynomial::x(std::pow(_p, i)), Polynomial{0, 1});
-        g = mod(g, f);
+        frobenius = powMod(frobenius, _p, f);
+        auto g = subtract(frobenius, x);
         if (gcd(g, f).degree() > 0)
             return false;
     }
     return true;
 }
 
+Polynomial PolynomialRing::lowestWeightIrreducible(size_t degree) const {
+    assert(degree > 0 && "degree should be positive");
+    if (degree == 1) {
+        return Polynomial{0, 1};
+    }
+
+    // x^degree + c can be irreducible only if every prime factor of the degree divides p - 1,
+    // and p = 1 (mod 4) when 4 divides the degree; otherwise all p - 1 binomials would be tried in vain
+    bool binomials = degree % 4 != 0 || _p % 4 == 1;
+    for (const auto prime : detail::primeFactors(degree)) {
+        binomials = binomials && (_p - 1) % prime == 0;
+    }
+    const auto max_coef = std::min<uint64_t>(_p - 1, LOWEST_WEIGHT_MAX_COEFFICIENT);
+
+    // x^degree and a non-zero constant term are always present, middle terms are added one by one
+    auto coefs = Polynomial::x(degree).coefficients();
+    for (size_t middle_terms = binomials ? 0 : 1; middle_terms < degree; middle_terms++) {
+        const std::function<bool(size_t, size_t)> search = [&](size_t term, size_t min_power) {
+            if (term == middle_terms) {
+                for (uint64_t constant = 1; constant <= max_coef; constant++) {
+                    coefs[0] = static_cast<int64_t>(constant);
+                    if (isIrreducible(Polynomial{coefs})) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            for (size_t power = min_power; power + (middle_terms - term) <= degree; power++) {
+                for (uint64_t coef = 1; coef <= max_coef; coef++) {
+                    coefs[power] = static_cast<int64_t>(coef);
+                    if (search(term + 1, power + 1)) {
+                        return true;
+                    }
+                }
+                coefs[power] = 0;
+            }
+            return false;
+        };
+
+        if (search(0, 1)) {
+            return Polynomial{coefs};
+        }
+    }
+
+    assert(false && "an irreducible polynomial exists for every degree");
+    return Polynomial{0};
+}
+
 int PolynomialRing::order_of_irreducible(const Polynomial &polynomial) const {
 
     assert (isIrreducible(polynomial));
-    const auto qm = static_cast<int64_t> (std::pow(getP(), polynomial.degree())) - 1;
+    const auto qm = detail::integerPow(getP(), polynomial.degree()) - 1;
 
     const auto factors = utils::get_divisors(qm);
 
     const auto grouped_factors = [&] {
-        std::vector<std::pair<int64_t, std::size_t>> grouped;
+        std::vector<std::pair<uint64_t, std::size_t>> grouped;
 
         for (const auto factor : factors) {
             if (!grouped.empty() && grouped.back().first == factor) {
@@ -361,31 +795,31 @@ int PolynomialRing::order_of_irreducible(const Polynomial &polynomial) const {
         return grouped;
     }();
 
-    auto e_divisors = std::vector<int64_t>{};
+    auto e_divisors = std::vector<uint64_t>{};
 
     for (auto[factor, amount] : grouped_factors) {
         auto powed_factor = factor;
         for (auto degree = 0; degree < amount; ++degree, powed_factor *= factor) {
-            if (mod(Polynomial::x(qm / powed_factor), polynomial) != Polynomial{1}) {
-                e_divisors.push_back(std::pow(factor, amount - degree));
+            if (powMod(Polynomial{0, 1}, qm / powed_factor, polynomial) != Polynomial{1}) {
+                e_divisors.push_back(detail::integerPow(factor, amount - degree));
                 break;
             }
 
         }
     }
-    return std::accumulate(e_divisors.begin(), e_divisors.end(), 1,
+    return std::accumulate(e_divisors.begin(), e_divisors.end(), uint64_t{1},
                            [](const auto sum, const auto divisor) {
                                return sum * divisor;
                            });
 }
 
 int PolynomialRing::order(const Polynomial &polynomial) const {
-    std::vector<int64_t> coefs = {0, 1};
+    const Polynomial x{0, 1};
+    // res = x^r mod polynomial
+    auto res = mod(x, polynomial);
+    int r = 1;
     while (true) {
-        auto curr = Polynomial(coefs);
-        auto res = mod(curr, polynomial);
         if (res.degree() == 0 && res.coefficient(0) < this->getP()) {
-            int r = static_cast<int>(coefs.size() - 1);
             int a = res.coefficient(0);
             int l = 1;
             while (a != 1) {
@@ -395,49 +829,41 @@ int PolynomialRing::order(const Polynomial &polynomial) const {
             }
             return l * r;
         }
-        coefs.insert(begin(coefs), 0);
+        res = mod(multiply(res, x), polynomial);
+        ++r;
     }
 }
 
 
 int PolynomialRing::countRoots(const Polynomial &polynomial, CountPolicy policy) const {
-    if (policy == PolynomialRing::CountPolicy::GCD) {
-        auto temp = subtract(Polynomial::x(this->getP()), Polynomial{0, 1}); //creating temp: x^mod - x
-        temp = gcd(polynomial, temp);
-        return temp.degree();
-    } else {
-        auto result = 0;
-
-        // check 0 is root or not:
-        if (polynomial.coefficient(0) == 0)
-            result++;
-
-        auto temp = subtract(Polynomial::x(this->getP() - 1), Polynomial{1}); //creating temp: x^mod - x
-
-        temp = gcd(polynomial, temp);
-
-        // b^mod-1 = 1, b in Fmod
-        if (temp.degree() == this->getP() - 1) {
-            int max_coef = temp.coefficient(temp.degree());
-            temp = subtract(temp, multiply(Polynomial::x(temp.degree()), max_coef));
-            temp = add(temp, Polynomial{max_coef});
-        }
-
-        // create circular matrix of coefs
-        std::vector<std::vector<uint64_t>> matrix;
+    const Polynomial x{0, 1};
+    const auto f = polynomial.modified(_reducer);
+    const bool reducible_powers = f.degree() > 0;
+
+    //creating temp: x^mod - x, reduced modulo polynomial when possible
+    const auto temp = reducible_powers ? subtract(powMod(x, getP(), polynomial), x)
+                                       : subtract(Polynomial::x(this->getP()), x);
+    if (policy == PolynomialRing::CountPolicy::GCD || !reducible_powers) {
+        return gcd(polynomial, temp).degree();
+    }
 
-        for (int i = 0; i <= temp.degree(); i++) {
-            std::vector<uint64_t> tmp_vec;
-            for (int j = 0; j <= temp.degree(); j++) {
-                tmp_vec.push_back(temp.coefficient((i + j) % (temp.degree() + 1)));
-            }
-            matrix.push_back(tmp_vec);
+    // the roots are those of g = gcd(f, temp); multiplication by temp on F_p[x]/(f) vanishes exactly on
+    // the multiples of f / g, so its kernel has dimension deg g; row i of its matrix is temp * x^i mod f
+    const auto monic = normalize(f);
+    const size_t n = monic.degree();
+    const auto remainder = mod(temp, monic);
+    detail::ModMatrix multiplication(n, n, _p);
+    std::vector<uint64_t> row(n, 0);
+    for (size_t j = 0; j < n; j++) {
+        row[j] = static_cast<uint64_t>(remainder.coefficient(j));
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            multiplication(i, j) = row[j];
         }
-
-        result += this->getP() - 1 - detail::rankOfMatrix(matrix);
-
-        return result;
+        _shift_mod(row, monic);
     }
+    return static_cast<int>(n - multiplication.rank());
 }
 
 std::vector<std::pair<int, uint64_t>> PolynomialRing::countMultipleRoots(const Polynomial &polynomial) const {
@@ -530,6 +956,370 @@ PolynomialRing::berlekampFactorization(Polynomial polynomial) const {
     }
 }
 
+std::vector<std::pair<Polynomial, std::size_t>> PolynomialRing::factorize(const Polynomial& polynomial) const {
+    const auto reduced = polynomial.modified(_reducer);
+    std::vector<std::pair<Polynomial, std::size_t>> result;
+    if (reduced.degree() == 0) {
+        return result;
+    }
+
+    for (const auto& [square_free, multiplicity] : _square_free_factorization(reduced)) {
+        if (_p <= BERLEKAMP_MAX_P && square_free.degree() <= BERLEKAMP_MAX_DEGREE) {
+            for (auto& factor : berlekampSplit(square_free)) {
+                result.emplace_back(std::move(factor), multiplicity);
+            }
+            continue;
+        }
+        for (const auto& [product, degree] : distinctDegreeFactorization(square_free)) {
+            for (auto& factor : equalDegreeFactorization(product, degree)) {
+                result.emplace_back(std::move(factor), multiplicity);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::pair<Polynomial, std::size_t>> PolynomialRing::berlekampFactorize(const Polynomial& polynomial) const {
+    const auto reduced = polynomial.modified(_reducer);
+    std::vector<std::pair<Polynomial, std::size_t>> result;
+    if (reduced.degree() == 0) {
+        return result;
+    }
+
+    for (const auto& [square_free, multiplicity] : _square_free_factorization(reduced)) {
+        for (auto& factor : berlekampSplit(square_free)) {
+            result.emplace_back(std::move(factor), multiplicity);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void PolynomialRing::_shift_mod(std::vector<uint64_t>& coefs, const Polynomial& monic) const {
+    const auto n = coefs.size();
+    const auto top = coefs[n - 1];
+    for (size_t j = n - 1; j > 0; j--) {
+        coefs[j] = coefs[j - 1];
+    }
+    coefs[0] = 0;
+    if (top != 0) {
+        for (size_t j = 0; j < n; j++) {
+            const auto term = _reducer.multiply(top, static_cast<uint64_t>(monic.coefficient(j)));
+            coefs[j] = coefs[j] >= term ? coefs[j] - term : coefs[j] + _p - term;
+        }
+    }
+}
+
+std::vector<Polynomial> PolynomialRing::berlekampSplit(const Polynomial& polynomial) const {
+    const auto f = normalize(polynomial);
+    const auto n = f.degree();
+    if (n <= 1) {
+        return {f};
+    }
+
+    // row i of Q - I is x^(i*p) mod f with 1 subtracted on the diagonal; x^(i*p) is found from x^((i-1)*p)
+    // by p shifts for small p, every shift folds x^n back with the lower coefficients of f
+    detail::ModMatrix transposed(n, n, _p);
+    const auto small = _p <= n;
+    const auto frobenius = small ? Polynomial{} : powMod(Polynomial{0, 1}, _p, f);
+    std::vector<uint64_t> row(n, 0);
+    row[0] = 1;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            transposed(j, i) = row[j];
+        }
+        transposed(i, i) = (transposed(i, i) + _p - 1) % _p;
+
+        if (small) {
+            for (uint64_t step = 0; step < _p; step++) {
+                _shift_mod(row, f);
+            }
+        } else {
+            Polynomial::storage_type coefs(row.begin(), row.end());
+            const auto next = mod(multiply(Polynomial{std::move(coefs)}, frobenius), f);
+            for (size_t j = 0; j < n; j++) {
+                row[j] = static_cast<uint64_t>(next.coefficient(j));
+            }
+        }
+    }
+
+    // v^T (Q - I) = 0 for the coefficients of every v with v^p = v mod f
+    const auto basis = transposed.nullspace();
+    std::vector<Polynomial> factors{f};
+    if (basis.size() == 1) {
+        return factors;
+    }
+
+    if (_p > BERLEKAMP_MAX_P) {
+        // trying every s costs O(p) gcds; instead a random combination w of the basis takes independent random
+        // values modulo the irreducible factors, and gcd(g, w^((p - 1) / 2) - 1) splits a factor g with
+        // probability about 1/2
+        std::mt19937_64 random{0x5eed5eed5eed5eedull};
+        std::uniform_int_distribution<uint64_t> coefficient{0, _p - 1};
+        const Polynomial unit{1};
+        while (factors.size() < basis.size()) {
+            std::vector<uint64_t> combination(n, 0);
+            for (const auto& vector : basis) {
+                const auto scale = coefficient(random);
+                for (size_t j = 0; j < n; j++) {
+                    combination[j] = _reducer.reduce(combination[j] + _reducer.multiply(scale, vector[j]));
+                }
+            }
+            Polynomial::storage_type coefs(combination.begin(), combination.end());
+            const Polynomial w{std::move(coefs)};
+
+            std::vector<Polynomial> refined;
+            for (auto& factor : factors) {
+                if (factor.degree() > 1) {
+                    const auto splitter = subtract(powMod(mod(w, factor), (_p - 1) / 2, factor), unit);
+                    const auto part = normalize(gcd(factor, splitter));
+                    if (part.degree() > 0 && part.degree() < factor.degree()) {
+                        refined.push_back(divide(factor, part));
+                        factor = part;
+                    }
+                }
+                refined.push_back(std::move(factor));
+            }
+            factors = std::move(refined);
+        }
+        std::sort(factors.begin(), factors.end());
+        return factors;
+    }
+
+    // every pair of irreducible factors is separated by some v - s from the basis
+    for (const auto& vector : basis) {
+        Polynomial::storage_type coefs(vector.begin(), vector.end());
+        const Polynomial v{std::move(coefs)};
+        if (v.degree() == 0) {
+            continue;
+        }
+
+        std::vector<Polynomial> refined;
+        for (const auto& factor : factors) {
+            auto rest = factor;
+            for (uint64_t s = 0; s < _p && rest.degree() > 1; s++) {
+                const auto part = normalize(gcd(rest, subtract(v, Polynomial{static_cast<int64_t>(s)})));
+                if (part.degree() > 0 && part.degree() < rest.degree()) {
+                    refined.push_back(part);
+                    rest = divide(rest, part);
+                }
+            }
+            refined.push_back(std::move(rest));
+        }
+        factors = std::move(refined);
+        if (factors.size() == basis.size()) {
+            break;
+        }
+    }
+
+    std::sort(factors.begin(), factors.end());
+    return factors;
+}
+
+std::vector<std::pair<Polynomial, std::size_t>> PolynomialRing::_square_free_factorization(const Polynomial& polynomial) const {
+    std::vector<std::pair<Polynomial, std::size_t>> result;
+    const Polynomial unit{1};
+    const auto monic = normalize(polynomial);
+    const auto derivative = derivate(monic);
+
+    // f' = 0 means f(x) = g(x^p) = g(x)^p over F_p
+    if (isZero(derivative)) {
+        for (auto& [factor, multiplicity] : _square_free_factorization(monic.unpowered(static_cast<int64_t>(_p)))) {
+            result.emplace_back(std::move(factor), multiplicity * _p);
+        }
+        return result;
+    }
+
+    // w collects the factors of multiplicity at least i which are not divisible by p, c keeps the rest
+    auto c = normalize(gcd(monic, derivative));
+    auto w = divide(monic, c);
+    for (std::size_t i = 1; w != unit; i++) {
+        const auto y = normalize(gcd(w, c));
+        const auto factor = divide(w, y);
+        if (factor != unit) {
+            result.emplace_back(factor, i);
+        }
+        w = y;
+        c = divide(c, y);
+    }
+
+    // what is left has only multiplicities divisible by p
+    if (c != unit) {
+        for (auto& [factor, multiplicity] : _square_free_factorization(c.unpowered(static_cast<int64_t>(_p)))) {
+            result.emplace_back(std::move(factor), multiplicity * _p);
+        }
+    }
+
+    return result;
+}
+
+std::vector<std::pair<Polynomial, std::size_t>> PolynomialRing::distinctDegreeFactorization(const Polynomial& polynomial) const {
+    auto rest = polynomial.modified(_reducer);
+    if (rest.degree() >= BSGS_DDF_THRESHOLD) {
+        return distinctDegreeFactorizationBSGS(rest);
+    }
+
+    std::vector<std::pair<Polynomial, std::size_t>> result;
+    const Polynomial x{0, 1};
+
+    // frobenius = x^(p^degree) mod rest, x^(p^d) - x is the product of all monic irreducibles of degrees dividing d
+    auto frobenius = mod(x, rest);
+    for (std::size_t degree = 1; 2 * degree <= rest.degree(); degree++) {
+        frobenius = powMod(frobenius, _p, rest);
+        const auto factor = normalize(gcd(rest, subtract(frobenius, x)));
+        if (factor.degree() > 0) {
+            result.emplace_back(factor, degree);
+            rest = divide(rest, factor);
+            frobenius = mod(frobenius, rest);
+        }
+    }
+
+    if (rest.degree() > 0) {
+        result.emplace_back(rest, rest.degree());
+    }
+
+    return result;
+}
+
+std::vector<std::pair<Polynomial, std::size_t>> PolynomialRing::distinctDegreeFactorizationBSGS(const Polynomial& polynomial) const {
+    std::vector<std::pair<Polynomial, std::size_t>> result;
+    const auto f = polynomial.modified(_reducer);
+    const auto n = f.degree();
+    if (n == 0) {
+        return result;
+    }
+    if (n == 1) {
+        result.emplace_back(f, 1);
+        return result;
+    }
+
+    const auto inverse = _product_inverse(f);
+    // k compositions with one polynomial cost about m + k * n / m products for blocks of m coefficients
+    const auto block_for = [n](size_t compositions) {
+        return std::min(n, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n * compositions)))));
+    };
+
+    // baby steps: baby[i] = x^(p^i) mod f for i < l, every step is a composition with x^p
+    const auto baby_count = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n) / 2)));
+    const auto frobenius = powMod(Polynomial{0, 1}, _p, f);
+    const auto frobenius_powers = _composition_powers(frobenius, block_for(baby_count), f, inverse);
+    std::vector<Polynomial> baby{mod(Polynomial{0, 1}, f)};
+    while (baby.size() <= baby_count) {
+        baby.push_back(_compose_mod(baby.back(), frobenius_powers, f, inverse));
+    }
+
+    // giant steps: giant[j] = x^(p^(l*j)) mod f for j = 1..m, every step is a composition with x^(p^l)
+    const auto giant_count = (n / 2 + baby_count - 1) / baby_count;
+    const auto giant_powers = _composition_powers(baby[baby_count], block_for(giant_count), f, inverse);
+    std::vector<Polynomial> giant{Polynomial{0}, baby[baby_count]};
+    while (giant.size() <= giant_count) {
+        giant.push_back(_compose_mod(giant.back(), giant_powers, f, inverse));
+    }
+
+    // x^(p^(l*j)) - x^(p^i) vanishes on the roots of irreducibles of degree d | l*j - i, so the interval product
+    // over i < l catches all degrees in (l*(j-1), l*j] with one gcd
+    auto rest = f;
+    for (size_t j = 1; j <= giant_count && 2 * baby_count * (j - 1) < rest.degree(); j++) {
+        auto interval = Polynomial{1};
+        for (size_t i = 0; i < baby_count; i++) {
+            interval = _reduce_product(PolynomialRing::multiply(interval, subtract(giant[j], baby[i])), f, inverse);
+        }
+        auto coarse = normalize(gcd(rest, interval));
+        if (coarse.degree() == 0) {
+            continue;
+        }
+        rest = divide(rest, coarse);
+
+        // the interval is refined from the lowest degree up, so factors of degrees dividing l*j - i are already gone
+        for (size_t i = baby_count; i-- > 0 && coarse.degree() > 0;) {
+            const auto degree = baby_count * j - i;
+            if (coarse.degree() < degree) {
+                break;
+            }
+            const auto fine = normalize(gcd(coarse, subtract(giant[j], baby[i])));
+            if (fine.degree() > 0) {
+                result.emplace_back(fine, degree);
+                coarse = divide(coarse, fine);
+            }
+        }
+    }
+
+    if (rest.degree() > 0) {
+        result.emplace_back(normalize(rest), rest.degree());
+    }
+
+    std::sort(result.begin(), result.end(), [](const auto& left, const auto& right) {
+        return left.second < right.second;
+    });
+    return result;
+}
+
+std::vector<Polynomial> PolynomialRing::equalDegreeFactorization(const Polynomial& polynomial, std::size_t degree) const {
+    // a fixed seed keeps factorization reproducible, the expected count of attempts does not depend on it
+    std::mt19937_64 random{0x5eed5eed5eed5eedull};
+
+    std::vector<Polynomial> result;
+    std::vector<Polynomial> pending{polynomial.modified(_reducer)};
+    while (!pending.empty()) {
+        auto current = std::move(pending.back());
+        pending.pop_back();
+        if (current.degree() <= degree) {
+            result.push_back(std::move(current));
+            continue;
+        }
+
+        auto factor = _split_equal_degree(current, degree, random);
+        pending.push_back(divide(current, factor));
+        pending.push_back(std::move(factor));
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+template <typename Random>
+Polynomial PolynomialRing::_split_equal_degree(const Polynomial& polynomial, std::size_t degree, Random& random) const {
+    std::uniform_int_distribution<uint64_t> coefficient{0, _p - 1};
+    const Polynomial unit{1};
+
+    while (true) {
+        Polynomial::storage_type coefs(polynomial.degree(), 0);
+        for (auto& item : coefs) {
+            item = static_cast<int64_t>(coefficient(random));
+        }
+        const Polynomial a{std::move(coefs)};
+        if (a.degree() == 0) {
+            continue;
+        }
+
+        auto factor = normalize(gcd(polynomial, a));
+        if (factor.degree() > 0 && factor.degree() < polynomial.degree()) {
+            return factor;
+        }
+
+        // every root of the polynomial lies in F_(p^degree), where the trace and the quadratic character
+        // of a take two values with roughly equal probability
+        auto power = a;
+        auto accumulated = a;
+        for (std::size_t i = 1; i < degree; i++) {
+            power = powMod(power, _p, polynomial);
+            accumulated = _p == 2 ? add(accumulated, power) : mod(multiply(accumulated, power), polynomial);
+        }
+        const auto splitter = _p == 2 ? accumulated : subtract(powMod(accumulated, (_p - 1) / 2, polynomial), unit);
+
+        if (isZero(splitter.modified(_reducer))) {
+            continue;
+        }
+        factor = normalize(gcd(polynomial, splitter));
+        if (factor.degree() > 0 && factor.degree() < polynomial.degree()) {
+            return factor;
+        }
+    }
+}
+
 size_t PolynomialRing::_rootMultiplicity(const Polynomial& polynomial, int64_t root) const {
     size_t result = 0;
 
@@ -555,7 +1345,7 @@ std::vector<uint64_t> PolynomialRing::chienSearch(const Polynomial &polynomial,
     size_t counter = 0;
 
     PolynomialField number_field{getP(), Polynomial{1, 1}};
-    auto gen = number_field.getGenerators()[0].coefficient(0);
+    auto gen = number_field.getGenerator().coefficient(0);
     std::vector<uint64_t> gen_power;
 
     gen_power.push_back(1);
@@ -594,9 +1384,13 @@ std::vector<uint64_t> PolynomialRing::chienSearch(const Polynomial &polynomial,
 
 namespace detail {
     std::vector<uint64_t> sieveOfEratosthenes(uint64_t n) {
+        if (n <= SIEVE_LIMIT) {
+            return LinearSieve::instance().primes(n);
+        }
+
         std::vector<char> prime(n + 1, true);
         prime[0] = prime[1] = false;
-        for (uint64_t i = 2; i <= n; ++i) {
+        for (uint64_t i = 2; i * i <= n; ++i) {
             if (prime[i]) {
                 for (uint64_t j = i * i; j <= n; j += i)
                     prime[j] = false;
@@ -612,22 +1406,15 @@ namespace detail {
     }
 
     int8_t moebiusFunction(uint64_t n) {
-        if (n == 1)
-            return 1;
-        if (prime(n))
-            return -1;
-        auto primes = sieveOfEratosthenes(static_cast<uint64_t>(n));
-        auto pow = true;
-        for (const auto &prime: primes) {
-            if (n % prime == 0) {
-                pow = !pow;
-                if (n % (prime * prime) == 0) {
-                    return 0;
-                }
-            }
+        if (n <= SIEVE_LIMIT) {
+            return LinearSieve::instance().moebius(n);
         }
 
-        return pow ? 1 : -1;
+        const auto factors = primeFactors(n);
+        if (std::adjacent_find(factors.begin(), factors.end()) != factors.end()) {
+            return 0;
+        }
+        return factors.size() % 2 == 0 ? 1 : -1;
     }
 
     Polynomial rPolynom(uint64_t i, uint64_t order, uint64_t polyMod) {
@@ -651,13 +1438,17 @@ namespace detail {
     }
 
     std::vector<uint64_t> integerFactorization(uint64_t n) {
-        std::vector<uint64_t> result;
-
-        for (uint64_t i = 1; i * i <= n; ++i) {
-            if (n % i == 0) {
-                result.push_back(i);
-                if (i * i != n) {
-                    result.push_back(n / i);
+        // every divisor is a product of prime powers, they are multiplied in one prime at a time
+        std::vector<uint64_t> result{1};
+        const auto factors = primeFactors(n);
+        for (size_t i = 0; i < factors.size();) {
+            const auto prime = factors[i];
+            const auto previous_count = result.size();
+            uint64_t power = 1;
+            for (; i < factors.size() && factors[i] == prime; i++) {
+                power *= prime;
+                for (size_t j = 0; j < previous_count; j++) {
+                    result.push_back(result[j] * power);
                 }
             }
         }
@@ -668,78 +1459,8 @@ namespace detail {
     }
 
 
-    void swap(std::vector<std::vector<uint64_t>> matrix, int row1, int row2, int col) {
-        for (int i = 0; i < col; i++) {
-            int temp = matrix[row1][i];
-            matrix[row1][i] = matrix[row2][i];
-            matrix[row2][i] = temp;
-        }
-    }
-
-/* function for finding rank of matrix */
-    int rankOfMatrix(std::vector<std::vector<uint64_t>> matrix) {
-        int rank = matrix[0].size();
-
-        for (int row = 0; row < rank; row++) {
-            // Before we visit current row 'row', we make
-            // sure that mat[row][0],....mat[row][row-1]
-            // are 0.
-
-            // Diagonal element is not zero
-            if (matrix[row][row]) {
-                for (int col = 0; col < matrix.size(); col++) {
-                    if (col != row) {
-                        // This makes all entries of current
-                        // column as 0 except entry 'mat[row][row]'
-                        double mult = (double) matrix[col][row] /
-                                      matrix[row][row];
-                        for (int i = 0; i < rank; i++)
-                            matrix[col][i] -= mult * matrix[row][i];
-                    }
-                }
-            }
-
-                // Diagonal element is already zero. Two cases
-                // arise:
-                // 1) If there is a row below it with non-zero
-                //    entry, then swap this row with that row
-                //    and process that row
-                // 2) If all elements in current column below
-                //    mat[r][row] are 0, then remvoe this column
-                //    by swapping it with last column and
-                //    reducing number of columns by 1.
-            else {
-                bool reduce = true;
-
-                /* Find the non-zero element in current
-                    column  */
-                for (int i = row + 1; i < matrix.size(); i++) {
-                    // Swap the row with non-zero element
-                    // with this row.
-                    if (matrix[i][row]) {
-                        swap(matrix, row, i, rank);
-                        reduce = false;
-                        break;
-                    }
-                }
-
-                // If we did not find any row with non-zero
-                // element in current columnm, then all
-                // values in this column are 0.
-                if (reduce) {
-                    // Reduce number of columns
-                    rank--;
-
-                    // Copy the last column here
-                    for (auto &i : matrix)
-                        i[row] = i[rank];
-                }
-
-                // Process this row again
-                row--;
-            }
-        }
-        return rank;
+    int rankOfMatrix(const std::vector<std::vector<uint64_t>>& matrix, uint64_t p) {
+        return static_cast<int>(ModMatrix(matrix, p).rank());
     }
 }//namespace detail
 
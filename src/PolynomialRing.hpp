@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Polynomial.hpp"
+#include "HashTable.hpp"
+
+#include <array>
+#include <memory>
+#include <mutex>
 
 namespace lab {
 
@@ -16,7 +21,10 @@ namespace lab {
 
         std::vector<uint64_t> integerFactorization(uint64_t n);
 
-        int rankOfMatrix(std::vector<std::vector<uint64_t>> matrix);
+        /**
+         * @return rank of the matrix over F_p
+         */
+        int rankOfMatrix(const std::vector<std::vector<uint64_t>>& matrix, uint64_t p);
     }//namespace detail
 
     class PolynomialRing {
@@ -56,9 +64,18 @@ namespace lab {
         [[nodiscard]]
         Polynomial gcd(Polynomial left, Polynomial right) const;
 
+        /**
+         * @note results are memoized per ring (copies share the memo) within CYCLOTOMIC_CACHE_BUDGET bytes
+         */
         [[nodiscard]]
         Polynomial cyclotomicPolinomial(uint64_t order) const;
 
+        /**
+         * @return memory taken by memoized cyclotomic polynomials in bytes
+         */
+        [[nodiscard]]
+        size_t cyclotomicCacheMemory() const;
+
         [[nodiscard]]
         std::vector<Polynomial> cyclotomicFactorization(uint64_t order) const;
 
@@ -68,6 +85,12 @@ namespace lab {
         [[nodiscard]]
         Polynomial pow(const Polynomial& num, uint64_t pow) const;
 
+        /**
+         * @return base^power mod modulus computed by square-and-multiply with reduction after every step
+         */
+        [[nodiscard]]
+        Polynomial powMod(const Polynomial& base, uint64_t power, const Polynomial& modulus) const;
+
         /**
          * @brief Finds normalized polynomial in field
          */
@@ -81,13 +104,22 @@ namespace lab {
         /**
          * @brief Calculates derivative from polynomial
          */
-        [[nodiscard]] Polynomial derivate(Polynomial &polynomial) const;
+        [[nodiscard]] Polynomial derivate(const Polynomial &polynomial) const;
 
         /**
          * @brief Checks if polynomial is irreducible over the field by modulo
          */
         [[nodiscard]] bool isIrreducible(const Polynomial &polynomial) const;
 
+        /**
+         * @return monic irreducible polynomial of the degree with the fewest non-zero coefficients,
+         *         ties are broken by the lowest middle powers and then by the lowest coefficients
+         * @note sparse moduli such as trinomials and pentanomials make field reduction cheaper
+         * @note coefficients are taken from 1..LOWEST_WEIGHT_MAX_COEFFICIENT, so for larger p the weight is
+         *       the lowest among such polynomials
+         */
+        [[nodiscard]] Polynomial lowestWeightIrreducible(size_t degree) const;
+
         /**
          *  @return Order of irreducible polynomial
          */
@@ -112,7 +144,9 @@ namespace lab {
 
         /**
          * @brief GCD method requires only GCD function,
-         *        Matrix method - uses matrix rank calculation
+         *        Matrix method - uses rank of the n x n matrix of multiplication by x^p - x on F_p[x]/(P(x))
+         * @note both methods compute x^p mod P(x) first; GCD then takes O(n^2) operations, while Matrix takes
+         *       O(n^3) for the elimination, so Matrix is slower for every degree and serves as a cross-check
          */
         enum class CountPolicy {
             GCD,
@@ -132,13 +166,218 @@ namespace lab {
         [[nodiscard]]
         std::vector<std::pair<Polynomial, std::size_t>> berlekampFactorization(Polynomial polynomial) const;
 
+        /**
+         * @return monic irreducible factors with their multiplicities in increasing order, the leading coefficient is dropped
+         * @note square-free decomposition, then distinct-degree and equal-degree (Cantor-Zassenhaus) factorization
+         * @note a random polynomial of degree 1000 takes about 1 s for p = 1000003, 1.5 s for p = 4294967291 and
+         *       2-4 s for p = 2^63 - 25 in a Release build; almost all of it goes to NTT products in the
+         *       baby-step giant-step distinct-degree stage
+         */
+        [[nodiscard]]
+        std::vector<std::pair<Polynomial, std::size_t>> factorize(const Polynomial& polynomial) const;
+
+        /**
+         * @return monic irreducible factors with their multiplicities in increasing order, like factorize
+         * @note square-free parts are split by the classical Berlekamp algorithm: polynomials v with v^p = v mod f
+         *       form the nullspace of Q - I, where row i of Q holds x^(i*p) mod f, and gcd(f, v - s) separate the factors
+         */
+        [[nodiscard]]
+        std::vector<std::pair<Polynomial, std::size_t>> berlekampFactorize(const Polynomial& polynomial) const;
+
+        /**
+         * @return irreducible factors of a monic square-free polynomial by the Berlekamp algorithm
+         * @note for p up to BERLEKAMP_MAX_P every v - s, s in F_p, is tried; for larger p the factors are split
+         *       by gcd(g, w^((p - 1) / 2) - 1) with random combinations w of the nullspace basis
+         */
+        [[nodiscard]]
+        std::vector<Polynomial> berlekampSplit(const Polynomial& polynomial) const;
+
+        /**
+         * @return pairs (product of all irreducible factors of degree d, d) for a monic square-free polynomial
+         * @note polynomials from BSGS_DDF_THRESHOLD degree on go through the baby-step giant-step algorithm
+         */
+        [[nodiscard]]
+        std::vector<std::pair<Polynomial, std::size_t>> distinctDegreeFactorization(const Polynomial& polynomial) const;
+
+        /**
+         * @brief baby-step giant-step distinct-degree factorization of Kaltofen and Shoup
+         * @note x^(p^i) for i < l and x^(p^(l*j)) are found by modular composition with x^p, the gcds are taken
+         *       with products (x^(p^(l*j)) - x^(p^i)) over whole intervals of degrees and refined only when they split
+         */
+        [[nodiscard]]
+        std::vector<std::pair<Polynomial, std::size_t>> distinctDegreeFactorizationBSGS(const Polynomial& polynomial) const;
+
+        /**
+         * @return g(h) mod modulus computed by the Brent-Kung algorithm
+         */
+        [[nodiscard]]
+        Polynomial composeMod(const Polynomial& g, const Polynomial& h, const Polynomial& modulus) const;
+
+        /**
+         * @return irreducible factors of a monic square-free polynomial whose irreducible factors all have the degree
+         * @note splits by gcd with a^((p^degree - 1) / 2) - 1 (or with the trace of a for p = 2) for pseudo-random a
+         */
+        [[nodiscard]]
+        std::vector<Polynomial> equalDegreeFactorization(const Polynomial& polynomial, std::size_t degree) const;
+
+        /**
+         * @brief rings with p up to this bound keep a table of inverses, larger ones invert on demand
+         */
+        static inline constexpr uint64_t INVERSE_TABLE_LIMIT = uint64_t{1} << 16;
+
+        /**
+         * @brief divisions where both the divisor and the quotient have at least this degree go through Newton iteration
+         */
+        static inline constexpr size_t NEWTON_DIVISION_THRESHOLD = 128;
+
+        /**
+         * @brief gcd of polynomials from this degree on is computed by the half-GCD algorithm
+         */
+        static inline constexpr size_t HALF_GCD_THRESHOLD = 1024;
+
+        /**
+         * @brief inside half-GCD, polynomials below this degree are walked through quotient by quotient
+         */
+        static inline constexpr size_t HALF_GCD_BASE_DEGREE = 128;
+
+        /**
+         * @brief distinct-degree factorization of polynomials from this degree on takes baby and giant steps
+         */
+        static inline constexpr size_t BSGS_DDF_THRESHOLD = 64;
+
+        /**
+         * @brief factorize splits square-free parts by Berlekamp instead of Cantor-Zassenhaus for p up to this bound ...
+         */
+        static inline constexpr uint64_t BERLEKAMP_MAX_P = 7;
+
+        /**
+         * @brief ... and degrees up to this one, beyond it the cubic elimination loses to distinct-degree factorization
+         */
+        static inline constexpr size_t BERLEKAMP_MAX_DEGREE = 512;
+
+        /**
+         * @brief lowestWeightIrreducible tries only coefficients up to this bound, an irreducible polynomial of
+         *        a given shape is usually found among the first few of them
+         */
+        static inline constexpr uint64_t LOWEST_WEIGHT_MAX_COEFFICIENT = 64;
+
+        /**
+         * @brief bytes which memoized cyclotomic polynomials of a ring may take, least recently used ones are dropped
+         */
+        static inline constexpr size_t CYCLOTOMIC_CACHE_BUDGET = size_t{4} << 20;
+
+    protected:
+        /**
+         * @return reducer of coefficients modulo p
+         */
+        [[nodiscard]] const detail::BarrettReducer& reducer() const;
+
+        /**
+         * @return x such that a * x = 1 (mod p)
+         */
+        [[nodiscard]] uint64_t _inverse(uint64_t a) const;
+
     private:
         uint64_t _p;
-        std::vector <std::vector <uint64_t>> _dividing_table;
+        detail::BarrettReducer _reducer;
+        // products of reduced polynomials up to this length (of the shorter one) fit into int64 exactly
+        size_t _max_exact_length;
+        // _inverses[a] * a = 1 (mod p), empty when p exceeds INVERSE_TABLE_LIMIT
+        std::vector<uint64_t> _inverses;
         [[nodiscard]] uint64_t _divide_coefficients(uint64_t a, uint64_t b) const;
-        void _create_dividing_table(int field);
+        void _create_inverses_table();
+
+        /**
+         * @return power series inverse of the reversed divisor modulo x^length
+         */
+        [[nodiscard]] Polynomial _reversed_inverse(const Polynomial& divisor, size_t length) const;
+
+        /**
+         * @brief divides reduced polynomials via multiplication by the inverse of the reversed divisor
+         * @param inverse is _reversed_inverse(divisor, length) for length not less than the quotient's one
+         */
+        [[nodiscard]] std::pair<Polynomial, Polynomial> _newton_div_mod(const Polynomial& divided, const Polynomial& divisor,
+                                                                       const Polynomial& inverse) const;
+
+        /**
+         * @return inverse of the reversed modulus for reduction of products by Newton division,
+         *         empty when the modulus is short enough for long division
+         */
+        [[nodiscard]] Polynomial _product_inverse(const Polynomial& modulus) const;
+
+        /**
+         * @return product mod modulus for a product of two polynomials reduced modulo the modulus
+         * @param inverse is _product_inverse(modulus)
+         */
+        [[nodiscard]] Polynomial _reduce_product(const Polynomial& product, const Polynomial& modulus, const Polynomial& inverse) const;
+
+        /**
+         * @brief replaces coefs, a polynomial of degree below deg monic, by x * coefs mod monic
+         */
+        void _shift_mod(std::vector<uint64_t>& coefs, const Polynomial& monic) const;
+
+        /**
+         * @return h^0, h^1, ..., h^count modulo the modulus, all of them needed to compose with h
+         */
+        [[nodiscard]] std::vector<Polynomial> _composition_powers(const Polynomial& h, size_t count, const Polynomial& modulus,
+                                                                  const Polynomial& inverse) const;
+
+        /**
+         * @return g(h) mod modulus, where powers are _composition_powers(h, m, modulus, inverse):
+         *         g is cut into blocks of m coefficients, every block is combined from h^0..h^(m-1)
+         *         and the blocks are joined by Horner's scheme in h^m
+         */
+        [[nodiscard]] Polynomial _compose_mod(const Polynomial& g, const std::vector<Polynomial>& powers, const Polynomial& modulus,
+                                              const Polynomial& inverse) const;
 
         [[nodiscard]] size_t _rootMultiplicity(const Polynomial& polynomial, int64_t root) const;
+
+        /**
+         * @return pairs (product of all irreducible factors of multiplicity m, m) for a polynomial of positive degree,
+         *         the products are monic
+         */
+        [[nodiscard]] std::vector<std::pair<Polynomial, std::size_t>> _square_free_factorization(const Polynomial& polynomial) const;
+
+        /**
+         * @return a non-trivial monic factor of a monic square-free polynomial with factors of the degree only,
+         *         the polynomial should be reducible
+         */
+        template <typename Random>
+        [[nodiscard]] Polynomial _split_equal_degree(const Polynomial& polynomial, std::size_t degree, Random& random) const;
+
+        struct CyclotomicCache {
+            std::mutex mutex;
+            // order -> cyclotomic polynomial in LRU order
+            detail::HashTable<uint64_t, Polynomial> entries;
+            size_t memory = 0;
+        };
+        std::shared_ptr<CyclotomicCache> _cyclotomic_cache = std::make_shared<CyclotomicCache>();
+
+        /**
+         * @brief builds Phi_n(x) = Phi_rad(x^(n / rad)) for the radical rad of n,
+         *        where Phi_rad is the product of (x^d - 1)^mu(rad / d) over the divisors d of rad
+         * @note every factor is a binomial applied in linear time modulo x^(phi(rad) + 1), so k distinct prime
+         *       factors take O(2^k * phi(rad)) time and O(phi(rad)) memory
+         */
+        [[nodiscard]] Polynomial _build_cyclotomic(uint64_t order) const;
+
+        // 2x2 matrix {m00, m01, m10, m11} mapping a pair of remainders to a later pair of the Euclidean sequence
+        using GcdMatrix = std::array<Polynomial, 4>;
+
+        /**
+         * @brief classical Euclidean algorithm running in place on two coefficient buffers
+         * @note right should be non-zero, both polynomials should be reduced
+         */
+        [[nodiscard]] Polynomial _euclid_gcd(const Polynomial& left, const Polynomial& right) const;
+
+        /**
+         * @return matrix taking (a, b), deg a > deg b, to consecutive remainders (c, d) with deg c >= (deg a + 1) / 2 > deg d
+         */
+        [[nodiscard]] GcdMatrix _half_gcd(const Polynomial& a, const Polynomial& b) const;
+
+        [[nodiscard]] std::pair<Polynomial, Polynomial> _apply(const GcdMatrix& matrix, const Polynomial& a, const Polynomial& b) const;
+
+        [[nodiscard]] GcdMatrix _compose(const GcdMatrix& left, const GcdMatrix& right) const;
     };
 
 } // namespace lab
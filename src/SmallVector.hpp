@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace lab::detail {
+
+/**
+ * @brief vector which keeps up to N elements inline and spills to the heap only when it grows larger
+ * @note restricted to trivially copyable types, so elements are moved around with memcpy
+ */
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector holds trivially copyable types only");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SmallVector() = default;
+
+    explicit SmallVector(size_t size, const T& value = T{}) {
+        assign(size, value);
+    }
+
+    SmallVector(std::initializer_list<T> items) : SmallVector(items.begin(), items.end()) {}
+
+    template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    SmallVector(InputIt first, InputIt last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    SmallVector(const std::vector<T>& items) : SmallVector(items.begin(), items.end()) {}
+
+    SmallVector(const SmallVector& that) {
+        _copyFrom(that);
+    }
+
+    SmallVector(SmallVector&& that) noexcept {
+        _moveFrom(that);
+    }
+
+    SmallVector& operator=(const SmallVector& that) {
+        if (this != &that) {
+            _size = 0;
+            _copyFrom(that);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& that) noexcept {
+        if (this != &that) {
+            _release();
+            _moveFrom(that);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        _release();
+    }
+
+    operator std::vector<T>() const {
+        return std::vector<T>(begin(), end());
+    }
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] size_t capacity() const { return _capacity; }
+    [[nodiscard]] bool empty() const { return _size == 0; }
+
+    /**
+     * @return true if the elements are kept inline, without a heap allocation
+     */
+    [[nodiscard]] bool isInline() const { return _data == _inline; }
+
+    T* data() { return _data; }
+    const T* data() const { return _data; }
+
+    iterator begin() { return _data; }
+    iterator end() { return _data + _size; }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    T& operator[](size_t index) { return _data[index]; }
+    const T& operator[](size_t index) const { return _data[index]; }
+
+    T& front() { return _data[0]; }
+    const T& front() const { return _data[0]; }
+    T& back() { return _data[_size - 1]; }
+    const T& back() const { return _data[_size - 1]; }
+
+    void push_back(const T& value) {
+        if (_size == _capacity) {
+            // the value may live inside this vector, so it is copied before the storage moves
+            const T copy = value;
+            _grow(_size + 1);
+            _data[_size++] = copy;
+            return;
+        }
+        _data[_size++] = value;
+    }
+
+    void pop_back() {
+        _size--;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity > _capacity) {
+            _reallocate(capacity);
+        }
+    }
+
+    void resize(size_t size, const T& value = T{}) {
+        if (size > _size) {
+            reserve(size);
+            std::fill(_data + _size, _data + size, value);
+        }
+        _size = size;
+    }
+
+    void assign(size_t size, const T& value) {
+        _size = 0;
+        resize(size, value);
+    }
+
+    void clear() {
+        _size = 0;
+    }
+
+    friend bool operator==(const SmallVector& left, const SmallVector& right) {
+        return left._size == right._size && std::equal(left.begin(), left.end(), right.begin());
+    }
+
+    friend bool operator!=(const SmallVector& left, const SmallVector& right) {
+        return !(left == right);
+    }
+
+private:
+    void _grow(size_t needed) {
+        _reallocate(std::max(needed, 2 * _capacity));
+    }
+
+    void _reallocate(size_t capacity) {
+        auto* data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        if (_size > 0) {
+            std::memcpy(data, _data, _size * sizeof(T));
+        }
+        _release();
+        _data = data;
+        _capacity = capacity;
+    }
+
+    void _release() {
+        if (!isInline()) {
+            ::operator delete(_data);
+            _data = _inline;
+            _capacity = N;
+        }
+    }
+
+    /**
+     * @brief copies elements of that into this vector, whose size must be 0
+     */
+    void _copyFrom(const SmallVector& that) {
+        reserve(that._size);
+        if (that._size > 0) {
+            std::memcpy(_data, that._data, that._size * sizeof(T));
+        }
+        _size = that._size;
+    }
+
+    /**
+     * @brief takes elements of that into this vector, which must have no heap storage; that becomes empty
+     */
+    void _moveFrom(SmallVector& that) {
+        if (that.isInline()) {
+            if (that._size > 0) {
+                std::memcpy(_inline, that._inline, that._size * sizeof(T));
+            }
+            _data = _inline;
+            _capacity = N;
+        } else {
+            _data = that._data;
+            _capacity = that._capacity;
+            that._data = that._inline;
+            that._capacity = N;
+        }
+        _size = that._size;
+        that._size = 0;
+    }
+
+    T* _data = _inline;
+    size_t _size = 0;
+    size_t _capacity = N;
+    T _inline[N];
+};
+
+} // namespace lab::detail
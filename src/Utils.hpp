@@ -1,25 +1,16 @@
 #pragma once
 
+#include "Factorization.hpp"
+
+#include <cstdint>
 #include <vector>
 
 namespace lab::utils {
 
     /**
-     *  @return All divisors of n
+     *  @return Prime divisors of n with multiplicity in increasing order
      */
-    std::vector<int> get_divisors(int64_t n) {
-        std::vector<int> result;
-
-        for (int64_t i = 2; i * i <= n; ++i) {
-
-            while (n % i == 0) {
-                result.push_back(i);
-                n /= i;
-            }
-        }
-        if (n != 1) {
-            result.push_back(n);
-        }
-        return result;
+    inline std::vector<uint64_t> get_divisors(uint64_t n) {
+        return detail::primeFactors(n);
     }
-}
\ No newline at end of file
+}
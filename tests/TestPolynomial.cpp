@@ -1,6 +1,24 @@
 #include "../src/Polynomial.hpp"
+#include "../src/Multiplication.hpp"
+#include "../src/HashTable.hpp"
 #include "catch.hpp"
 
+#include <random>
+
+namespace {
+/**
+ * @return count residues modulo modulus drawn uniformly by random, which tests seed with a constant to stay reproducible
+ */
+std::vector<int64_t> randomResidues(std::mt19937_64& random, uint64_t modulus, size_t count) {
+    std::uniform_int_distribution<uint64_t> residue{0, modulus - 1};
+    std::vector<int64_t> result(count);
+    for (auto& item : result) {
+        item = static_cast<int64_t>(residue(random));
+    }
+    return result;
+}
+}
+
 TEST_CASE("Polynomials test", "[Polynomial]") {
     using namespace lab;
 
@@ -186,6 +204,75 @@ TEST_CASE("Polynomials test", "[Polynomial]") {
             REQUIRE(p3 * p4 == p4 * p3);
             REQUIRE((p3 * p4).degree() == 18);
         }
+
+        SECTION("karatsuba") {
+            std::vector<int64_t> coefs1, coefs2;
+            for (int64_t i = 0; i < 300; i++) {
+                coefs1.push_back((i * 37 + 11) % 201 - 100);
+            }
+            for (int64_t i = 0; i < 1000; i++) {
+                coefs2.push_back((i * i * 13 + 5) % 157 - 78);
+            }
+            const Polynomial p1{coefs1};
+            const Polynomial p2{coefs2};
+
+            std::vector<int64_t> expected(coefs1.size() + coefs2.size() - 1, 0);
+            for (size_t i = 0; i < coefs1.size(); i++) {
+                for (size_t j = 0; j < coefs2.size(); j++) {
+                    expected[i + j] += coefs1[i] * coefs2[j];
+                }
+            }
+
+            REQUIRE(p1 * p2 == Polynomial{expected});
+            REQUIRE(p2 * p1 == Polynomial{expected});
+            REQUIRE(p1 * p1 == Polynomial{detail::schoolbookMultiply(coefs1, coefs1)});
+        }
+
+        SECTION("ntt") {
+            for (const uint64_t modulus : {2ull, 1000000007ull, 18446744073709551557ull}) {
+                std::mt19937_64 random{12345};
+                const auto coefs1 = randomResidues(random, modulus, 200);
+                const auto coefs2 = randomResidues(random, modulus, 333);
+
+                const auto result = detail::nttMultiply(coefs1, coefs2, modulus);
+                REQUIRE(result.size() == coefs1.size() + coefs2.size() - 1);
+
+                for (size_t k = 0; k < result.size(); k++) {
+                    unsigned __int128 expected = 0;
+                    for (size_t i = 0; i < coefs1.size() && i <= k; i++) {
+                        if (k - i < coefs2.size()) {
+                            expected += static_cast<unsigned __int128>(static_cast<uint64_t>(coefs1[i]))
+                                        * static_cast<uint64_t>(coefs2[k - i]) % modulus;
+                            expected %= modulus;
+                        }
+                    }
+                    REQUIRE(static_cast<uint64_t>(result[k]) == static_cast<uint64_t>(expected));
+                }
+
+                // the 128-bit schoolbook kernel overflows its sum for moduli close to 2^64 and has to agree anyway
+                std::vector<int64_t> schoolbook(result.size());
+                detail::schoolbookMultiplyMod(coefs1.data(), coefs1.size(), coefs2.data(), coefs2.size(), modulus, schoolbook.data());
+                REQUIRE(schoolbook == result);
+
+                // products longer than NTT_MAX_LENGTH are assembled from products of blocks
+                for (const size_t block : {7, 64, 200}) {
+                    REQUIRE(detail::nttMultiplyBlocks(coefs1, coefs2, modulus, block) == result);
+                }
+
+                // a square transforms its single operand once and has to agree with the general product
+                const auto copy = coefs2;
+                REQUIRE(detail::nttMultiply(coefs2, coefs2, modulus) == detail::nttMultiply(coefs2, copy, modulus));
+            }
+
+            // near 2^63 the sums of (p - 1)^2 terms overflow int64, so the blocks must be added modulo p
+            const uint64_t modulus = 9223372036854775783ull;
+            const std::vector<int64_t> ones(300, static_cast<int64_t>(modulus - 1));
+            const auto blocks = detail::nttMultiplyBlocks(ones, ones, modulus, 128);
+            REQUIRE(blocks == detail::nttMultiply(ones, ones, modulus));
+            for (size_t k = 0; k < blocks.size(); k++) {
+                REQUIRE(static_cast<uint64_t>(blocks[k]) == std::min(k + 1, blocks.size() - k));
+            }
+        }
     }
 
     SECTION("Modifying by modulo") {
@@ -200,6 +287,15 @@ TEST_CASE("Polynomials test", "[Polynomial]") {
 
         Polynomial p4{1, 14, 10, 2, 1, 7, 8};
         REQUIRE(to_string(p4.modified(17)) == to_string(p4));
+
+        Polynomial p5{-1000000000000, 1000000000001, INT64_MIN, INT64_MAX};
+        REQUIRE(p5.modified(3) == Polynomial{2, 2, 1, 1});
+
+        const detail::BarrettReducer reducer3{3};
+        REQUIRE(p5.modified(reducer3) == p5.modified(3));
+        const detail::BarrettReducer reducer{1000000007};
+        REQUIRE(p3.modified(reducer) == p3.modified(1000000007));
+        REQUIRE(p5.modified(reducer) == p5.modified(1000000007));
     }
     
     SECTION("Derivative") {
@@ -239,4 +335,62 @@ TEST_CASE("Polynomials test", "[Polynomial]") {
         Polynomial p5{0, 1};
         REQUIRE(p5.evaluate(23) == 23);
     }
+
+    SECTION("Hashing") {
+        const std::hash<Polynomial> hash;
+        REQUIRE(hash(Polynomial{}) == hash(Polynomial{0, 0}));
+        REQUIRE(hash(Polynomial{1, 2, 3, 0}) == hash(Polynomial{1, 2, 3}));
+        REQUIRE(hash(Polynomial{1, 2, 3}) != hash(Polynomial{3, 2, 1}));
+        REQUIRE(hash(Polynomial{1, 2, 3}) != hash(Polynomial{1, 2, 3, 0, 1}));
+
+        detail::HashTable<Polynomial, int> table;
+        for (int i = 0; i < 100; i++) {
+            table.insert(Polynomial{i, 1}, i);
+        }
+        REQUIRE(table.size() == 100);
+        REQUIRE(*table.find(Polynomial{42, 1}) == 42);
+        REQUIRE(table.find(Polynomial{42}) == nullptr);
+
+        // the least recently used entry goes last
+        REQUIRE(table.backKey() == Polynomial{0, 1});
+        REQUIRE(*table.get(Polynomial{0, 1}) == 0);
+        REQUIRE(table.backKey() == Polynomial{1, 1});
+
+        for (int i = 1; i < 50; i++) {
+            table.popBack();
+        }
+        REQUIRE(table.erase(Polynomial{99, 1}));
+        REQUIRE(!table.erase(Polynomial{99, 1}));
+        REQUIRE(table.size() == 50);
+        REQUIRE(table.backKey() == Polynomial{50, 1});
+
+        std::vector<int> values;
+        table.forEach([&values](const Polynomial&, int value) { values.push_back(value); });
+        REQUIRE(values.front() == 0);
+        REQUIRE(values.back() == 50);
+        REQUIRE(values.size() == 50);
+    }
+
+    SECTION("Coefficient storage") {
+        const Polynomial small{1, 2, 3};
+        REQUIRE(small.coefficients().isInline());
+        REQUIRE(Polynomial::x(Polynomial::INLINE_COEFFICIENTS - 1).coefficients().isInline());
+
+        const auto large = Polynomial::x(100) + small;
+        REQUIRE(!large.coefficients().isInline());
+        REQUIRE(large.degree() == 100);
+        REQUIRE(large.coefficient(2) == 3);
+
+        auto copied = large;
+        REQUIRE(copied == large);
+        auto moved = std::move(copied);
+        REQUIRE(moved == large);
+        moved = small;
+        REQUIRE(moved == small);
+        moved = std::move(moved) * Polynomial::x(50);
+        REQUIRE(moved.coefficient(52) == 3);
+
+        const std::vector<int64_t> as_vector = large.coefficients();
+        REQUIRE(Polynomial{as_vector} == large);
+    }
 }
@@ -4,6 +4,11 @@
 #include "catch.hpp"
 #include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
 
 TEST_CASE("Polynomial Field test", "[Polynomial field]") {
     using namespace lab;
@@ -329,6 +334,218 @@ TEST_CASE("Polynomial Field test", "[Polynomial field]") {
         }
     }
 
+    SECTION("lazy elements") {
+        PolynomialField F9{ 3, {1, 0, 1} };
+        const auto elements = F9.elements();
+        REQUIRE(elements[0] == Polynomial{ 0 });
+        REQUIRE(elements[5] == Polynomial{ 2, 1 });
+        REQUIRE(elements[8] == Polynomial{ 2, 2 });
+        for (uint64_t i = 0; i < elements.size(); i++) {
+            REQUIRE(elements.indexOf(elements[i]) == i);
+        }
+        REQUIRE(std::vector<Polynomial>(elements.begin(), elements.end()).size() == 9);
+        REQUIRE(std::is_same_v<std::iterator_traits<PolynomialField::ElementRange::iterator>::iterator_category,
+                               std::input_iterator_tag>);
+
+        // 3^40 still fits into 64 bits, 3^41 does not
+        REQUIRE(PolynomialField(3, Polynomial::x(40) + Polynomial{2, 1}).getQ() == 12157665459056928801ull);
+        REQUIRE_THROWS_AS(PolynomialField(3, Polynomial::x(41) + Polynomial{2, 1}), std::invalid_argument);
+
+        // x^32 + x^7 + x^3 + x^2 + 1
+        PolynomialField F2_32{ 2, Polynomial::x(32) + Polynomial{1, 0, 1, 1, 0, 0, 0, 1} };
+        REQUIRE(F2_32.getQ() == 4294967296ull);
+        REQUIRE(F2_32.elements().size() == 4294967296ull);
+        REQUIRE(F2_32.elements()[4294967295ull] == Polynomial(std::vector<int64_t>(32, 1)));
+        REQUIRE(F2_32.elements().indexOf(Polynomial{1, 0, 1}) == 5);
+
+        // x^8 + x + 2 over F101, only its size matters here
+        PolynomialField F101_8{ 101, Polynomial{2, 1, 0, 0, 0, 0, 0, 0, 1} };
+        REQUIRE(F101_8.getQ() == 10828567056280801ull);
+        const auto element = Polynomial{100, 0, 3, 0, 0, 0, 0, 7};
+        REQUIRE(F101_8.elements()[F101_8.elements().indexOf(element)] == element);
+    }
+
+    SECTION("packed elements") {
+        for (const auto& field : {PolynomialField{ 3, {1, 0, 1} }, PolynomialField{ 2, {1, 1, 1} },
+                                  PolynomialField{ 5, {2, 0, 1} }, PolynomialField{ 13, {1, 1} }}) {
+            for (const auto& left : field.elements()) {
+                const auto packed_left = field.toElement(left);
+                REQUIRE(field.toPolynomial(packed_left) == left);
+
+                for (const auto& right : field.elements()) {
+                    const auto packed_right = field.toElement(right);
+                    REQUIRE(field.toPolynomial(field.add(packed_left, packed_right)) == field.add(left, right));
+                    REQUIRE(field.toPolynomial(field.subtract(packed_left, packed_right)) == field.subtract(left, right));
+                    REQUIRE(field.toPolynomial(field.multiply(packed_left, packed_right)) == field.multiply(left, right));
+                }
+
+                REQUIRE(field.toPolynomial(field.pow(packed_left, 7)) == field.pow(left, 7));
+                if (left != Polynomial{ 0 }) {
+                    REQUIRE(field.multiply(packed_left, field.inverted(packed_left)) == PolynomialField::Element{1});
+                }
+            }
+        }
+
+        // x^32 + x^7 + x^3 + x^2 + 1
+        PolynomialField F2_32{ 2, Polynomial::x(32) + Polynomial{1, 0, 1, 1, 0, 0, 0, 1} };
+        const auto element = F2_32.toElement(Polynomial{1, 1, 0, 1, 0, 0, 0, 0, 0, 1});
+        REQUIRE(F2_32.multiply(element, F2_32.inverted(element)) == PolynomialField::Element{1});
+        REQUIRE(F2_32.pow(element, F2_32.getQ() - 1) == PolynomialField::Element{1});
+    }
+
+    SECTION("log tables") {
+        PolynomialField F9{ 3, {1, 0, 1} };
+        const PolynomialField plain{ F9 };
+
+        REQUIRE(!F9.hasLogTables());
+        REQUIRE(F9.logTablesMemory() == 0);
+        REQUIRE(!F9.enableLogTables(8));
+        REQUIRE(F9.enableLogTables());
+        REQUIRE(F9.hasLogTables());
+        REQUIRE(F9.logTablesMemory() >= (9 + 2 * 8) * sizeof(uint32_t));
+
+        for (const auto& left : F9.elements()) {
+            const auto packed_left = F9.toElement(left);
+            for (const auto& right : F9.elements()) {
+                const auto packed_right = F9.toElement(right);
+                REQUIRE(F9.multiply(packed_left, packed_right) == plain.multiply(packed_left, packed_right));
+                REQUIRE(F9.multiply(left, right) == plain.multiply(left, right));
+            }
+            for (uint64_t power = 0; power < 20; power++) {
+                REQUIRE(F9.pow(packed_left, power) == plain.pow(packed_left, power));
+            }
+            if (left != Polynomial{ 0 }) {
+                REQUIRE(F9.inverted(packed_left) == plain.inverted(packed_left));
+                REQUIRE(F9.inverted(left) == plain.inverted(left));
+            }
+        }
+
+        // x^16 + x^5 + x^3 + x^2 + 1, large enough to be filled by several threads
+        PolynomialField F2_16{ 2, Polynomial::x(16) + Polynomial{1, 0, 1, 1, 0, 1} };
+        const PolynomialField plain_2_16{ F2_16 };
+        REQUIRE(F2_16.enableLogTables());
+        for (uint64_t value = 1; value < F2_16.getQ(); value += 997) {
+            const PolynomialField::Element element{value};
+            const PolynomialField::Element other{(value * 7919) % F2_16.getQ()};
+            REQUIRE(F2_16.multiply(element, other) == plain_2_16.multiply(element, other));
+            REQUIRE(F2_16.inverted(element) == plain_2_16.inverted(element));
+        }
+    }
+
+    SECTION("reduction") {
+        // dense moduli go through the reduction table, the monic and the non-monic one differ by a constant factor;
+        // sparse ones go through the sparse kernel, x^2 + 1 over the largest prime below 2^32 as well
+        for (const auto& [p, irreducible, sparse] : {
+                std::make_tuple(uint64_t{3}, Polynomial{1, 1, 1, 1, 1, 1, 1}, false),
+                std::make_tuple(uint64_t{3}, Polynomial{2, 2, 2, 2, 2, 2, 2}, false),
+                std::make_tuple(uint64_t{3}, Polynomial::x(12) + Polynomial{2, 1}, true),
+                std::make_tuple(uint64_t{1009}, Polynomial{1, 2, 0, 0, 0, 1}, true),
+                std::make_tuple(uint64_t{4294967291}, Polynomial{1, 0, 1}, true)}) {
+            const PolynomialField field{p, irreducible};
+            REQUIRE(field.hasSparseModulus() == sparse);
+            const PolynomialRing ring{p};
+            for (uint64_t i = 1; i < 100; i++) {
+                const auto left = field.toPolynomial(PolynomialField::Element{i * 7919 % field.getQ()});
+                const auto right = field.toPolynomial(PolynomialField::Element{i * 104729 % field.getQ()});
+                REQUIRE(field.multiply(left, right) == ring.mod(ring.multiply(left, right), irreducible));
+            }
+
+            // degrees above 2n - 2 are folded before the table is applied
+            const auto high = ring.pow(Polynomial{1, 1, 2}, 20);
+            REQUIRE(field.inverted(high) == field.inverted(ring.mod(high, irreducible)));
+        }
+
+        // the lowest weight irreducible of degree 8 over F2 is a pentanomial, which is still sparse
+        REQUIRE(PolynomialField{2, PolynomialRing{2}.lowestWeightIrreducible(8)}.hasSparseModulus());
+    }
+
+    SECTION("batch inversion") {
+        PolynomialField F9{ 3, {1, 0, 1} };
+        std::vector<Polynomial> elements(F9.elements().begin(), F9.elements().end());
+        const auto inverses = F9.invertMany(elements);
+        REQUIRE(inverses.size() == elements.size());
+        for (size_t i = 0; i < elements.size(); i++) {
+            if (elements[i] == Polynomial{0}) {
+                REQUIRE(inverses[i] == Polynomial{0});
+            } else {
+                REQUIRE(F9.multiply(elements[i], inverses[i]) == Polynomial{1});
+                REQUIRE(inverses[i] == F9.inverted(elements[i]));
+            }
+        }
+
+        // x^32 + x^7 + x^3 + x^2 + 1 over F2 and x^5 + 2x + 1 over F1009
+        PolynomialField F2_32{ 2, Polynomial::x(32) + Polynomial{1, 0, 1, 1, 0, 0, 0, 1} };
+        PolynomialField F1009_5{ 1009, Polynomial{1, 2, 0, 0, 0, 1} };
+        for (const auto* field : {&F2_32, &F1009_5}) {
+            std::vector<Polynomial> batch;
+            for (uint64_t index = 0; index < 200; index++) {
+                batch.push_back(field->toPolynomial(PolynomialField::Element{index * 2654435761u % field->getQ()}));
+            }
+            const auto batch_inverses = field->invertMany(batch);
+            for (size_t i = 0; i < batch.size(); i++) {
+                REQUIRE(batch_inverses[i] == field->inverted(batch[i]));
+                if (batch[i] != Polynomial{0}) {
+                    REQUIRE(field->multiply(batch[i], batch_inverses[i]) == Polynomial{1});
+                }
+            }
+        }
+    }
+
+    SECTION("multiplication cache") {
+        auto& cache = detail::FieldMultiplicationCache::instance();
+        cache.clear();
+
+        PolynomialField F9{ 3, {1, 0, 1} };
+        const Polynomial a{ 1, 2 };
+        const Polynomial b{ 2, 2 };
+
+        const auto result = F9.multiply(a, b);
+        REQUIRE(cache.stats().misses == 1);
+        REQUIRE(cache.stats().entries == 1);
+        REQUIRE(F9.multiply(a, b) == result);
+        REQUIRE(F9.multiply(b, a) == result);
+        REQUIRE(cache.stats().hits == 2);
+        REQUIRE(cache.stats().entries == 1);
+
+        // x^8 + x^4 + x^3 + x + 1
+        PolynomialField F2_8{ 2, Polynomial::x(8) + Polynomial{1, 1, 0, 1, 1} };
+        std::vector<std::thread> threads;
+        std::vector<int> failures(4, 0);
+        for (size_t t = 0; t < failures.size(); t++) {
+            threads.emplace_back([&, t]() {
+                for (uint64_t left = t; left < F2_8.getQ(); left += 3) {
+                    for (uint64_t right = 0; right < F2_8.getQ(); right += 17) {
+                        const auto product = F2_8.multiply(F2_8.toPolynomial(PolynomialField::Element{left}),
+                                                           F2_8.toPolynomial(PolynomialField::Element{right}));
+                        if (F2_8.toElement(product) != F2_8.multiply(PolynomialField::Element{left}, PolynomialField::Element{right})) {
+                            failures[t]++;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(failures == std::vector<int>(4, 0));
+        REQUIRE(cache.stats().hits > 2);
+
+        cache.clear();
+        cache.setMemoryBudget(size_t{64} << 10);
+        for (uint64_t left = 0; left < 200; left++) {
+            REQUIRE(F2_8.multiply(F2_8.toPolynomial(PolynomialField::Element{left}), F2_8.toPolynomial(PolynomialField::Element{left + 1})).degree() < 8);
+        }
+        const auto stats = cache.stats();
+        REQUIRE(stats.evictions > 0);
+        REQUIRE(stats.memory <= size_t{64} << 10);
+        REQUIRE(stats.entries + stats.evictions == 200);
+
+        cache.setMemoryBudget(detail::FieldMultiplicationCache::DEFAULT_MEMORY_BUDGET);
+        cache.clear();
+        REQUIRE(cache.stats().entries == 0);
+        REQUIRE(cache.stats().hits == 0);
+    }
+
     SECTION("generators") {
         PolynomialField F13{13, Polynomial{1, 1}};
         REQUIRE(F13.isGenerator(Polynomial{2}));
@@ -340,5 +557,26 @@ TEST_CASE("Polynomial Field test", "[Polynomial field]") {
 
         std::vector<Polynomial> generators{Polynomial{2}, Polynomial{6}, Polynomial{7}, Polynomial{11}};
         REQUIRE(F13.getGenerators() == generators);
+        REQUIRE(F13.getGenerator() == Polynomial{2});
+        REQUIRE(!F13.isGenerator(Polynomial{0}));
+
+        // q - 1 = 100002 = 2 * 3 * 7 * 2381, so there are phi(q - 1) = 28560 generators
+        PolynomialField large{100003, Polynomial{0, 1}};
+        const auto large_generators = large.getGenerators();
+        REQUIRE(large_generators.size() == 28560);
+        REQUIRE(std::is_sorted(large_generators.begin(), large_generators.end()));
+        REQUIRE(large_generators.front() == large.getGenerator());
+        for (size_t i = 0; i < large_generators.size(); i += 1009) {
+            REQUIRE(large.isGenerator(large_generators[i]));
+            REQUIRE(large.pow(large_generators[i], 50001) != Polynomial{1});
+        }
+
+        // x generates F_16^* for the primitive x^4 + x + 1, but not for x^4 + x^3 + x^2 + x + 1 where x^5 = 1
+        PolynomialField F16{2, Polynomial{1, 1, 0, 0, 1}};
+        REQUIRE(F16.isGenerator(Polynomial{0, 1}));
+        REQUIRE(F16.getGenerators().size() == 8);
+        PolynomialField F16_other{2, Polynomial{1, 1, 1, 1, 1}};
+        REQUIRE(!F16_other.isGenerator(Polynomial{0, 1}));
+        REQUIRE(F16_other.getGenerators().size() == 8);
     }
 }
@@ -1,7 +1,29 @@
 #include "../src/PolynomialRing.hpp"
+#include "../src/Factorization.hpp"
+#include "../src/ModMatrix.hpp"
+#include "../src/BinaryMatrix.hpp"
+#include "../src/ModularArithmetic.hpp"
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <random>
+#include <thread>
+
+namespace {
+/**
+ * @return count residues modulo p drawn uniformly by random, which tests seed with a constant to stay reproducible
+ */
+std::vector<int64_t> randomResidues(std::mt19937_64& random, uint64_t p, size_t count) {
+    std::uniform_int_distribution<uint64_t> residue{0, p - 1};
+    std::vector<int64_t> result(count);
+    for (auto& item : result) {
+        item = static_cast<int64_t>(residue(random));
+    }
+    return result;
+}
+}
+
 TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
     using namespace lab;
 
@@ -168,6 +190,43 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
             REQUIRE(ring157.multiply(p5, p6) == Polynomial{91, 57, 49, 16, 127, 68, 95, 45, 90, 26, 63, 16, 45, 150, 152, 17, 33, 133});
             REQUIRE(ring157.multiply(p6, p5) == Polynomial{91, 57, 49, 16, 127, 68, 95, 45, 90, 26, 63, 16, 45, 150, 152, 17, 33, 133});
         }
+
+        SECTION("large degree") {
+            std::vector<int64_t> coefs1, coefs2;
+            for (int64_t i = 0; i < 1500; i++) {
+                coefs1.push_back((i * i * 31 + 7) % 1009);
+                coefs2.push_back((i * 17 + 3) % 1009 - 500);
+            }
+            const Polynomial p1{coefs1};
+            const Polynomial p2{coefs2};
+
+            const PolynomialRing ring5{5};
+            REQUIRE(ring5.multiply(p1, p2) == (p1 * p2).modified(5));
+
+            const PolynomialRing ring1009{1009};
+            REQUIRE(ring1009.multiply(p1, p2) == (p1 * p2).modified(1009));
+            REQUIRE(ring1009.multiply(p2, p1) == ring1009.multiply(p1, p2));
+        }
+
+        SECTION("large prime") {
+            // products of such coefficients overflow int64 already for short polynomials
+            const uint64_t p = 4294967311;
+            const PolynomialRing ring{p};
+            std::vector<int64_t> coefs1, coefs2;
+            for (int64_t i = 0; i < 20; i++) {
+                coefs1.push_back(static_cast<int64_t>(p - 1 - i * 12345));
+                coefs2.push_back(static_cast<int64_t>(p - 7 - i * i));
+            }
+
+            std::vector<int64_t> expected(coefs1.size() + coefs2.size() - 1, 0);
+            for (size_t i = 0; i < coefs1.size(); i++) {
+                for (size_t j = 0; j < coefs2.size(); j++) {
+                    expected[i + j] = static_cast<int64_t>((detail::mulMod(coefs1[i], coefs2[j], p) + expected[i + j]) % p);
+                }
+            }
+            REQUIRE(ring.multiply(Polynomial{coefs1}, Polynomial{coefs2}) == Polynomial{expected});
+            REQUIRE(ring.multiply(Polynomial{coefs1}, p - 1) == ring.subtract(Polynomial{0}, Polynomial{coefs1}));
+        }
     }
 
     SECTION("Division") {
@@ -257,6 +316,42 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
                 REQUIRE(ring23.mod(px, py) == Polynomial{3,22,21,11});
             }
 
+            SECTION("Large prime"){
+                const PolynomialRing ring65537{65537};
+                const PolynomialRing ring1000003{1000003};
+
+                const Polynomial px{7, 30, 0, 0, 10, 6, 0, 15, 23};
+                const Polynomial py{4, 17, 0, 0, 5};
+                const Polynomial pr{3, 2, 1};
+
+                for (const auto& ring : {ring65537, ring1000003}) {
+                    const auto dividend = ring.add(ring.multiply(px, py), pr);
+                    REQUIRE(ring.div_mod(dividend, py) == std::make_pair(px, pr));
+                    REQUIRE(ring.divide(px, Polynomial{2}) == ring.multiply(px, (ring.getP() + 1) / 2));
+                }
+            }
+
+            SECTION("Large degree"){
+                // both the divisor and the quotient are long enough for Newton iteration
+                std::vector<int64_t> quotient_coefs, divisor_coefs, remainder_coefs;
+                for (int64_t i = 0; i < 700; i++) {
+                    quotient_coefs.push_back((i * i * 13 + 5) % 1009);
+                }
+                for (int64_t i = 0; i < 300; i++) {
+                    divisor_coefs.push_back((i * 29 + 11) % 1009);
+                    remainder_coefs.push_back((i * i + 3 * i) % 1009);
+                }
+                remainder_coefs.pop_back();
+
+                const PolynomialRing ring1009{1009};
+                const Polynomial quotient{quotient_coefs};
+                const Polynomial divisor{divisor_coefs};
+                const Polynomial remainder{remainder_coefs};
+                const auto dividend = ring1009.add(ring1009.multiply(quotient, divisor), remainder);
+                REQUIRE(ring1009.div_mod(dividend, divisor) == std::make_pair(quotient, remainder));
+                REQUIRE(ring1009.powMod(Polynomial{1, 1}, 5000, divisor) == ring1009.mod(ring1009.pow(Polynomial{1, 1}, 5000), divisor));
+            }
+
 
 
         }
@@ -307,6 +402,34 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
             Polynomial gg3 = Polynomial{3, 3, 1, 1};
             REQUIRE(ring5.normalize(g3) == ring5.normalize(gg3));
         }
+
+        SECTION("large degree") {
+            const PolynomialRing ring1009{1009};
+            std::vector<int64_t> common_coefs, coefs1, coefs2;
+            for (int64_t i = 0; i <= 400; i++) {
+                common_coefs.push_back((i * i * 7 + 3) % 1009);
+            }
+            for (int64_t i = 0; i <= 1300; i++) {
+                coefs1.push_back((i * i * i + 5 * i + 1) % 1009);
+                coefs2.push_back((i * 37 + i * i * 11 + 2) % 1009);
+            }
+            coefs2.resize(1201);
+            const Polynomial common{common_coefs};
+            const auto a = ring1009.multiply(Polynomial{coefs1}, common);
+            const auto b = ring1009.multiply(Polynomial{coefs2}, common);
+
+            // half-GCD must reproduce the last remainder of the plain Euclidean algorithm exactly
+            Polynomial left = a, right = b;
+            while (right != Polynomial{0}) {
+                left = ring1009.mod(left, right);
+                std::swap(left, right);
+            }
+            const auto result = ring1009.gcd(a, b);
+            REQUIRE(result == left);
+            REQUIRE(ring1009.mod(result, common) == Polynomial{0});
+            REQUIRE(ring1009.mod(a, result) == Polynomial{0});
+            REQUIRE(ring1009.mod(b, result) == Polynomial{0});
+        }
     }
 
     SECTION("Derivative") {
@@ -347,6 +470,11 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
 
         Polynomial p5{0, 1};
         REQUIRE(r.evaluate(p5, 42) == 9);
+
+        // x^40 + 1 at the point 3 overflows int64 without reduction
+        const PolynomialRing r1000003{1000003};
+        Polynomial p6 = Polynomial::x(40) + Polynomial{1};
+        REQUIRE(r1000003.evaluate(p6, 3) == (detail::powMod(3, 40, 1000003) + 1) % 1000003);
     }
 
     SECTION("Normalize") {
@@ -371,6 +499,39 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
             REQUIRE(detail::moebiusFunction(190) == -1);
             REQUIRE(detail::moebiusFunction(214) == 1);
             REQUIRE(detail::moebiusFunction(5 * 13 * 17) == -1);
+            // beyond the sieve the value comes from the factorization
+            REQUIRE(detail::moebiusFunction(998244359987710471) == 1);
+            REQUIRE(detail::moebiusFunction(uint64_t{1} << 40) == 0);
+        }
+        SECTION("linear sieve") {
+            auto& sieve = detail::LinearSieve::instance();
+            REQUIRE(detail::sieveOfEratosthenes(30) == std::vector<uint64_t>{2, 3, 5, 7, 11, 13, 17, 19, 23, 29});
+            REQUIRE(sieve.size() >= 30);
+
+            // concurrent readers grow the tables and agree with the factorization
+            std::vector<std::thread> readers;
+            std::vector<int> mismatches(4, 0);
+            for (size_t t = 0; t < mismatches.size(); t++) {
+                readers.emplace_back([&, t]() {
+                    for (uint64_t n = 1 + t; n <= 20000; n += 97) {
+                        const auto factors = detail::primeFactors(n);
+                        const bool square_free = std::adjacent_find(factors.begin(), factors.end()) == factors.end();
+                        const int expected = square_free ? (factors.size() % 2 == 0 ? 1 : -1) : 0;
+                        mismatches[t] += sieve.moebius(n) != expected;
+                    }
+                });
+            }
+            for (auto& reader : readers) {
+                reader.join();
+            }
+            REQUIRE(mismatches == std::vector<int>(4, 0));
+            REQUIRE(sieve.size() >= 20000);
+            REQUIRE(sieve.size() <= detail::SIEVE_LIMIT);
+
+            std::vector<uint64_t> factors;
+            REQUIRE(sieve.factorize(19000, factors));
+            REQUIRE(factors == std::vector<uint64_t>{2, 2, 2, 5, 5, 5, 19});
+            REQUIRE(detail::sieveOfEratosthenes(20000).size() == 2262);
         }
         SECTION("Cyclotomic") {
             SECTION("F11"){
@@ -403,6 +564,49 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
                 const PolynomialRing r{13};
                 REQUIRE(r.cyclotomicPolinomial(1) == Polynomial{12, 1});
             }
+            SECTION("memoized") {
+                const PolynomialRing r{5};
+                // x^n - 1 is the product of Phi_d over the divisors d of n
+                for (uint64_t n = 1; n <= 210; n++) {
+                    Polynomial product{1};
+                    for (const auto d : detail::integerFactorization(n)) {
+                        product = r.multiply(product, r.cyclotomicPolinomial(d));
+                    }
+                    REQUIRE(product == r.subtract(Polynomial::x(n), Polynomial{1}));
+                }
+                // Phi_1000(x) = Phi_10(x^100) = x^400 - x^300 + x^200 - x^100 + 1
+                const auto phi1000 = r.cyclotomicPolinomial(1000);
+                REQUIRE(phi1000 == Polynomial::x(400) + 4 * Polynomial::x(300) + Polynomial::x(200) + 4 * Polynomial::x(100) + Polynomial{1});
+                REQUIRE(r.cyclotomicPolinomial(1000) == phi1000);
+
+                // copies share the memo, which stays within its budget
+                const auto copy = r;
+                const auto memory = copy.cyclotomicCacheMemory();
+                REQUIRE(memory > 0);
+                for (const uint64_t prime : {99991, 99989, 99971, 99961, 99929, 99923, 99907}) {
+                    REQUIRE(copy.cyclotomicPolinomial(prime).degree() == prime - 1);
+                }
+                REQUIRE(r.cyclotomicCacheMemory() > memory);
+                REQUIRE(r.cyclotomicCacheMemory() <= PolynomialRing::CYCLOTOMIC_CACHE_BUDGET);
+            }
+            SECTION("many prime factors") {
+                // 30030 = 2 * 3 * 5 * 7 * 11 * 13, the product of its numerator binomials alone has degree 51264
+                const uint64_t p = 1000003;
+                const PolynomialRing r{p};
+                const auto even = r.cyclotomicPolinomial(30030);
+                REQUIRE(even.degree() == 5760);
+
+                // Phi_2m(x) = Phi_m(-x) for odd m
+                const auto odd = r.cyclotomicPolinomial(15015);
+                REQUIRE(odd.degree() == even.degree());
+                bool reflected = true;
+                for (size_t i = 0; i <= odd.degree(); i++) {
+                    const auto expected = i % 2 == 0 || odd.coefficient(i) == 0 ? odd.coefficient(i)
+                                                                              : static_cast<int64_t>(p) - odd.coefficient(i);
+                    reflected = reflected && even.coefficient(i) == expected;
+                }
+                REQUIRE(reflected);
+            }
         }
     }
     SECTION("Cyclotomic factorization") {
@@ -484,6 +688,63 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
                 REQUIRE(!r.isIrreducible(Polynomial{6, 5, 6, 1, 1}));
                 REQUIRE(!r.isIrreducible(Polynomial{6, 6, 6, 6, 1}));
             }
+            SECTION("large degree") {
+                const PolynomialRing r{2};
+                // x^64 + x^4 + x^3 + x + 1
+                auto f = Polynomial::x(64) + Polynomial{1, 1, 0, 1, 1};
+                REQUIRE(r.isIrreducible(f));
+                REQUIRE(!r.isIrreducible(r.multiply(f, Polynomial{1, 1, 1})));
+            }
+        }
+
+        SECTION("Lowest weight irreducible") {
+            const auto weight = [](const Polynomial& f) {
+                return std::count_if(f.coefficients().begin(), f.coefficients().end(),
+                                     [](int64_t coef) { return coef != 0; });
+            };
+
+            const PolynomialRing F2{2};
+            REQUIRE(F2.lowestWeightIrreducible(1) == Polynomial{0, 1});
+            REQUIRE(F2.lowestWeightIrreducible(7) == Polynomial::x(7) + Polynomial{1, 1});
+
+            // there are no irreducible trinomials of degree 8 over F2
+            const auto octic = F2.lowestWeightIrreducible(8);
+            REQUIRE(octic.degree() == 8);
+            REQUIRE(weight(octic) == 5);
+            REQUIRE(F2.isIrreducible(octic));
+
+            REQUIRE(PolynomialRing{3}.lowestWeightIrreducible(2) == Polynomial{1, 0, 1});
+            REQUIRE(PolynomialRing{7}.lowestWeightIrreducible(3) == Polynomial{2, 0, 0, 1});
+
+            // 3 does not divide p - 1 for these primes, so there are no irreducible binomials of degree 3
+            for (const uint64_t p : {uint64_t{10000019}, uint64_t{4294967291}}) {
+                const PolynomialRing r{p};
+                const auto cubic = r.lowestWeightIrreducible(3);
+                REQUIRE(cubic.degree() == 3);
+                REQUIRE(weight(cubic) == 3);
+                REQUIRE(r.isIrreducible(cubic));
+            }
+
+            // p = 2^63 - 25 is 1 mod 3 but 3 mod 4: binomials exist for degree 3, not for degree 4
+            const PolynomialRing large{9223372036854775783ull};
+            const auto cubic = large.lowestWeightIrreducible(3);
+            REQUIRE(weight(cubic) == 2);
+            REQUIRE(large.isIrreducible(cubic));
+            const auto quartic = large.lowestWeightIrreducible(4);
+            REQUIRE(quartic.degree() == 4);
+            REQUIRE(weight(quartic) == 3);
+            REQUIRE(large.isIrreducible(quartic));
+        }
+
+        SECTION("Modular powering") {
+            const PolynomialRing r3{3};
+            REQUIRE(r3.powMod(Polynomial{0, 1}, 10, Polynomial{1, 0, 1}) == Polynomial{2});
+            REQUIRE(r3.powMod(Polynomial{1, 1}, 0, Polynomial{1, 0, 1}) == Polynomial{1});
+            REQUIRE(r3.powMod(Polynomial{2, 1}, 5, Polynomial{0, 0, 0, 0, 0, 0, 1}) == r3.pow(Polynomial{2, 1}, 5));
+
+            const PolynomialRing r7{7};
+            const Polynomial f{3, 1, 4, 1, 5};
+            REQUIRE(r7.powMod(Polynomial{0, 1}, 1000, f) == r7.mod(Polynomial::x(1000), f));
         }
 
         SECTION ("Order of irreducible") {
@@ -567,11 +828,186 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
     }
 
 
+    SECTION("Factorization") {
+        SECTION("square-free, distinct-degree and equal-degree steps") {
+            const PolynomialRing r7{7};
+            const Polynomial cubic{2, 0, 0, 1};
+            const auto f = r7.multiply(r7.multiply(r7.pow(Polynomial{1, 1}, 2), Polynomial{1, 0, 1}),
+                                       r7.multiply(cubic, Polynomial{3, 1}));
+            using Factors = std::vector<std::pair<Polynomial, std::size_t>>;
+            REQUIRE(r7.factorize(f) == Factors{{Polynomial{1, 1}, 2}, {Polynomial{3, 1}, 1}, {Polynomial{1, 0, 1}, 1}, {cubic, 1}});
+            // the leading coefficient is dropped
+            REQUIRE(r7.factorize(r7.multiply(f, 3)) == r7.factorize(f));
+            REQUIRE(r7.factorize(Polynomial{5}).empty());
+
+            const auto square_free = r7.multiply(r7.multiply(Polynomial{1, 1}, Polynomial{3, 1}), r7.multiply(Polynomial{1, 0, 1}, cubic));
+            REQUIRE(r7.distinctDegreeFactorization(square_free) == Factors{
+                    {r7.multiply(Polynomial{1, 1}, Polynomial{3, 1}), 1}, {Polynomial{1, 0, 1}, 2}, {cubic, 3}});
+            REQUIRE(r7.equalDegreeFactorization(Polynomial{0, 6, 0, 0, 0, 0, 0, 1}, 1).size() == 7);
+        }
+
+        SECTION("multiplicities divisible by p") {
+            const PolynomialRing r3{3};
+            // (x^3 - x)^3 * (x^2 + 1) = (x (x + 1) (x + 2))^3 * (x^2 + 1)
+            const auto f = r3.multiply(r3.pow(Polynomial{0, 2, 0, 1}, 3), Polynomial{1, 0, 1});
+            REQUIRE(r3.factorize(f) == std::vector<std::pair<Polynomial, std::size_t>>{
+                    {Polynomial{0, 1}, 3}, {Polynomial{1, 1}, 3}, {Polynomial{2, 1}, 3}, {Polynomial{1, 0, 1}, 1}});
+            REQUIRE(r3.factorize(r3.pow(Polynomial{1, 0, 1}, 9)) == std::vector<std::pair<Polynomial, std::size_t>>{{Polynomial{1, 0, 1}, 9}});
+        }
+
+        SECTION("characteristic 2") {
+            const PolynomialRing r2{2};
+            // x^8 - x is the product of all irreducibles of degrees 1 and 3
+            REQUIRE(r2.factorize(Polynomial{0, 1, 0, 0, 0, 0, 0, 0, 1}) == std::vector<std::pair<Polynomial, std::size_t>>{
+                    {Polynomial{0, 1}, 1}, {Polynomial{1, 1}, 1}, {Polynomial{1, 1, 0, 1}, 1}, {Polynomial{1, 0, 1, 1}, 1}});
+            const auto factors = r2.equalDegreeFactorization(r2.cyclotomicPolinomial(255), 8);
+            REQUIRE(factors.size() == 16);
+            REQUIRE(std::all_of(factors.begin(), factors.end(), [&](const auto& factor) { return r2.isIrreducible(factor); }));
+        }
+
+        SECTION("baby-step giant-step") {
+            for (const uint64_t p : {2ull, 3ull, 1000003ull, 9223372036854775783ull}) {
+                const PolynomialRing ring{p};
+                std::mt19937_64 random{p};
+
+                // composition agrees with Horner's scheme
+                auto modulus_coefs = randomResidues(random, p, 41);
+                const auto g_coefs = randomResidues(random, p, 57);
+                const auto h_coefs = randomResidues(random, p, 40);
+                modulus_coefs.back() = 1;
+                const Polynomial modulus{modulus_coefs}, g{g_coefs}, h{h_coefs};
+                Polynomial horner{0};
+                for (size_t i = g.degree() + 1; i-- > 0;) {
+                    horner = ring.add(ring.mod(ring.multiply(horner, h), modulus), Polynomial{g.coefficient(i)});
+                }
+                REQUIRE(ring.composeMod(g, h, modulus) == horner);
+
+                // both distinct-degree factorizations agree on square-free parts of random polynomials
+                for (const size_t degree : {17, 40}) {
+                    auto coefs = randomResidues(random, p, degree + 1);
+                    coefs.back() = 1;
+                    Polynomial f{coefs};
+                    const auto square_free = ring.divide(f, ring.normalize(ring.gcd(f, ring.derivate(f))));
+                    REQUIRE(ring.distinctDegreeFactorizationBSGS(square_free) == ring.distinctDegreeFactorization(square_free));
+                }
+            }
+
+            // x^(3^6) - x is the product of all irreducibles over F_3 of degrees 1, 2, 3 and 6
+            const PolynomialRing r3{3};
+            const auto all = r3.subtract(Polynomial::x(729), Polynomial{0, 1});
+            const auto by_degree = r3.distinctDegreeFactorization(all);
+            REQUIRE(by_degree.size() == 4);
+            const std::vector<std::pair<size_t, size_t>> counts{{1, 3}, {2, 3}, {3, 8}, {6, 116}};
+            for (size_t i = 0; i < counts.size(); i++) {
+                REQUIRE(by_degree[i].second == counts[i].first);
+                REQUIRE(by_degree[i].first.degree() == counts[i].first * counts[i].second);
+            }
+        }
+
+        SECTION("Berlekamp") {
+            for (const uint64_t p : {2ull, 3ull, 5ull, 7ull, 1009ull}) {
+                const PolynomialRing ring{p};
+                std::mt19937_64 random{p};
+                for (const size_t degree : {9, 30, 70}) {
+                    auto coefs = randomResidues(random, p, degree + 1);
+                    coefs.back() = 1;
+                    const Polynomial f{coefs};
+
+                    const auto factors = ring.berlekampFactorize(f);
+                    Polynomial product{1};
+                    for (const auto& [factor, multiplicity] : factors) {
+                        REQUIRE(ring.isIrreducible(factor));
+                        product = ring.multiply(product, ring.pow(factor, multiplicity));
+                    }
+                    REQUIRE(product == f);
+                    REQUIRE(ring.berlekampFactorize(ring.multiply(f, f)).size() == factors.size());
+                }
+            }
+
+            // for large p the nullspace basis is combined at random instead of trying every v - s
+            for (const uint64_t p : {1000003ull, 9223372036854775783ull}) {
+                const PolynomialRing ring{p};
+                std::mt19937_64 random{p};
+                auto coefs = randomResidues(random, p, 31);
+                coefs.back() = 1;
+                const Polynomial f{coefs};
+                const auto product = ring.multiply(ring.multiply(f, Polynomial{3, 1}), Polynomial{5, 0, 1});
+                REQUIRE(ring.berlekampFactorize(product) == ring.factorize(product));
+            }
+
+            const PolynomialRing r2{2};
+            REQUIRE(r2.berlekampSplit(Polynomial{0, 1, 0, 0, 0, 0, 0, 0, 1}) == std::vector{
+                    Polynomial{0, 1}, Polynomial{1, 1}, Polynomial{1, 1, 0, 1}, Polynomial{1, 0, 1, 1}});
+            REQUIRE(r2.berlekampSplit(Polynomial{1, 1, 0, 0, 0, 0, 0, 1}) == std::vector{Polynomial{1, 1, 0, 0, 0, 0, 0, 1}});
+        }
+
+        SECTION("large prime") {
+            const uint64_t p = 9223372036854775783ull;
+            const PolynomialRing ring{p};
+            std::vector<int64_t> coefs(25);
+            for (size_t i = 0; i < coefs.size(); i++) {
+                coefs[i] = static_cast<int64_t>(detail::powMod(3, i * i + 7, p));
+            }
+            coefs.back() = 1;
+            const Polynomial f{coefs};
+
+            Polynomial product{1};
+            for (const auto& [factor, multiplicity] : ring.factorize(f)) {
+                REQUIRE(ring.isIrreducible(factor));
+                REQUIRE(factor.coefficient(factor.degree()) == 1);
+                product = ring.multiply(product, ring.pow(factor, multiplicity));
+            }
+            REQUIRE(product == f);
+
+            // power * coef overflows int64 in the derivative, which has to be taken modulo p
+            const auto derivative = ring.derivate(Polynomial{0, 0, 0, static_cast<int64_t>(p - 1)});
+            REQUIRE(derivative == Polynomial{0, 0, static_cast<int64_t>(p - 3)});
+
+            // (x - 1)^2 (x - 2) is not square-free
+            const auto p_ = static_cast<int64_t>(p);
+            REQUIRE(ring.factorize(Polynomial{p_ - 2, 5, p_ - 4, 1}) == std::vector<std::pair<Polynomial, size_t>>{
+                    {Polynomial{p_ - 2, 1}, 1}, {Polynomial{p_ - 1, 1}, 2}});
+            const auto square = ring.multiply(f, f);
+            const auto factors = ring.factorize(square);
+            product = Polynomial{1};
+            for (const auto& [factor, multiplicity] : factors) {
+                REQUIRE(multiplicity % 2 == 0);
+                product = ring.multiply(product, ring.pow(factor, multiplicity));
+            }
+            REQUIRE(product == square);
+        }
+    }
+
     SECTION("Integer number factorization") {
         REQUIRE(detail::integerFactorization(24) == std::vector<uint64_t>{1, 2, 3, 4, 6, 8, 12, 24});
         REQUIRE(detail::integerFactorization(101) == std::vector<uint64_t>{1, 101});
         REQUIRE(detail::integerFactorization(25) == std::vector<uint64_t>{1, 5, 25});
         REQUIRE(detail::integerFactorization(256) == std::vector<uint64_t>{1, 2, 4, 8, 16, 32, 64, 128, 256});
+        REQUIRE(detail::integerFactorization(998244359987710471) == std::vector<uint64_t>{1, 998244353, 1000000007, 998244359987710471});
+
+        SECTION("primality") {
+            REQUIRE(!detail::isPrime(0));
+            REQUIRE(!detail::isPrime(1));
+            REQUIRE(detail::isPrime(2));
+            REQUIRE(detail::isPrime(37));
+            REQUIRE(!detail::isPrime(561));
+            // strong pseudoprime to the bases 2, 3, 5 and 7
+            REQUIRE(!detail::isPrime(3215031751));
+            REQUIRE(detail::isPrime(4294967291));
+            REQUIRE(!detail::isPrime(4294967297));
+            REQUIRE(detail::isPrime(18446744073709551557ull));
+            REQUIRE(!detail::isPrime(18446743979220271189ull));
+        }
+
+        SECTION("prime factors") {
+            REQUIRE(detail::primeFactors(1).empty());
+            REQUIRE(detail::primeFactors(97) == std::vector<uint64_t>{97});
+            REQUIRE(detail::primeFactors(uint64_t{1} << 62) == std::vector<uint64_t>(62, 2));
+            REQUIRE(detail::primeFactors(UINT64_MAX) == std::vector<uint64_t>{3, 5, 17, 257, 641, 65537, 6700417});
+            REQUIRE(detail::primeFactors(18446743979220271189ull) == std::vector<uint64_t>{4294967279, 4294967291});
+            REQUIRE(detail::primeFactors(detail::integerPow(3, 40) - 1)
+                    == std::vector<uint64_t>{2, 2, 2, 2, 2, 5, 5, 11, 11, 41, 61, 1181, 42521761});
+        }
     }
 
     SECTION("Irreducible polynomials of given order") {
@@ -624,6 +1060,21 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
 
         SECTION("Matrix") {
             REQUIRE(r5.countRoots(Polynomial{1, 1, 1, 1}, PolynomialRing::CountPolicy::Matrix) == 3);
+            REQUIRE(r5.countRoots(Polynomial{0, 1, 1}, PolynomialRing::CountPolicy::Matrix) == 2);
+            REQUIRE(r5.countRoots(Polynomial{1, 0, 1, 0, 0, 0, 0, 0, 1}, PolynomialRing::CountPolicy::Matrix) ==
+                    r5.countRoots(Polynomial{1, 0, 1, 0, 0, 0, 0, 0, 1}));
+            REQUIRE(r5.countRoots(Polynomial{2}, PolynomialRing::CountPolicy::Matrix) == 0);
+
+            for (const uint64_t p : {2ull, 7ull, 1009ull, 9223372036854775783ull}) {
+                const PolynomialRing ring{p};
+                std::mt19937_64 random{p};
+                for (size_t attempt = 0; attempt < 10; attempt++) {
+                    auto coefs = randomResidues(random, p, 2 + attempt * 5);
+                    coefs.back() = 1;
+                    const Polynomial f{coefs};
+                    REQUIRE(ring.countRoots(f, PolynomialRing::CountPolicy::Matrix) == ring.countRoots(f));
+                }
+            }
         }
     }
 
@@ -634,22 +1085,161 @@ TEST_CASE("Polynomial Rings test", "[Polynomial ring]") {
                     {40, 70, 10},
                     {30, 50, 0}
             };
-            REQUIRE(detail::rankOfMatrix(matrix) == 2);
+            REQUIRE(detail::rankOfMatrix(matrix, 7) == 2);
+            REQUIRE(detail::rankOfMatrix(matrix, 5) == 0);
 
             matrix = {
                     {1, 0, 0},
                     {0, 1, 0},
                     {0, 0, 1}
             };
-            REQUIRE(detail::rankOfMatrix(matrix) == 3);
+            REQUIRE(detail::rankOfMatrix(matrix, 7) == 3);
 
             matrix = {
                     {2, 1, 0},
                     {2, 1, 0},
                     {6, 3, 0}
             };
-            REQUIRE(detail::rankOfMatrix(matrix) == 1);
+            REQUIRE(detail::rankOfMatrix(matrix, 7) == 1);
+
+            // the first column is zero, so the rank is only found after a row swap
+            matrix = {
+                    {0, 1, 2},
+                    {0, 3, 4},
+                    {0, 0, 0},
+                    {0, 5, 6}
+            };
+            REQUIRE(detail::rankOfMatrix(matrix, 7) == 2);
+            REQUIRE(detail::rankOfMatrix(matrix, 2) == 1);
+        }
+
+        SECTION("nullspace and solve") {
+            // x + 2y = 0, 2x + 4y = 0 over F_5 leaves the line through (3, 1)
+            const detail::ModMatrix singular({{1, 2}, {2, 4}}, 5);
+            REQUIRE(singular.rank() == 1);
+            REQUIRE(singular.nullspace() == std::vector<std::vector<uint64_t>>{{3, 1}});
+            REQUIRE(singular.solve({1, 2}) == std::vector<uint64_t>{1, 0});
+            REQUIRE_FALSE(singular.solve({1, 1}).has_value());
+            REQUIRE(detail::ModMatrix({{1, 0}, {0, 1}}, 5).nullspace().empty());
+
+            const detail::ModMatrix wide({{1, 1, 1, 1}, {0, 1, 2, 3}}, 7);
+            const auto basis = wide.nullspace();
+            REQUIRE(basis.size() == 2);
+            for (const auto& vector : basis) {
+                for (size_t i = 0; i < wide.rows(); i++) {
+                    uint64_t sum = 0;
+                    for (size_t j = 0; j < wide.columns(); j++) {
+                        sum += wide(i, j) * vector[j];
+                    }
+                    REQUIRE(sum % 7 == 0);
+                }
+            }
+        }
+
+        SECTION("delayed reduction") {
+            // Vandermonde matrices on distinct points have full rank, equal points collapse it
+            for (const uint64_t p : {3ull, 65521ull, 4294967291ull, 9223372036854775783ull}) {
+                const size_t n = p == 3 ? 3 : 40;
+                detail::ModMatrix vandermonde(n, n, p);
+                detail::ModMatrix repeated(n, n, p);
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t power = 1;
+                    uint64_t repeated_power = 1;
+                    for (size_t j = 0; j < n; j++) {
+                        vandermonde(i, j) = power;
+                        repeated(i, j) = repeated_power;
+                        power = detail::mulMod(power, i + 1, p);
+                        repeated_power = detail::mulMod(repeated_power, i % 5 + 1, p);
+                    }
+                }
+                REQUIRE(vandermonde.rank() == n);
+                REQUIRE(vandermonde.nullspace().empty());
+                REQUIRE(repeated.rank() == std::min<size_t>(n, 5));
+
+                std::vector<uint64_t> ones(n, 1);
+                const auto solution = vandermonde.solve(ones);
+                REQUIRE(solution.has_value());
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t sum = 0;
+                    for (size_t j = 0; j < n; j++) {
+                        sum = (sum + detail::mulMod(vandermonde(i, j), (*solution)[j], p)) % p;
+                    }
+                    REQUIRE(sum == 1);
+                }
+            }
+        }
+    }
+
+    SECTION("Binary matrix") {
+        // L * diag(1, ..., 1, 0, ..., 0) * U with unit triangular L and U has rank equal to the count of ones
+        std::mt19937_64 random{2};
+        for (const auto& [rows, columns, rank] : std::vector<std::tuple<size_t, size_t, size_t>>{
+                {1, 1, 1}, {3, 5, 2}, {64, 64, 64}, {70, 130, 61}, {150, 100, 99}, {200, 200, 0}}) {
+            std::vector<std::vector<uint64_t>> lower(rows, std::vector<uint64_t>(rows, 0));
+            std::vector<std::vector<uint64_t>> upper(columns, std::vector<uint64_t>(columns, 0));
+            for (size_t i = 0; i < rows; i++) {
+                lower[i][i] = 1;
+                for (size_t j = 0; j < i; j++) {
+                    lower[i][j] = random() & 1;
+                }
+            }
+            for (size_t i = 0; i < columns; i++) {
+                upper[i][i] = 1;
+                for (size_t j = i + 1; j < columns; j++) {
+                    upper[i][j] = random() & 1;
+                }
+            }
+            std::vector<std::vector<uint64_t>> entries(rows, std::vector<uint64_t>(columns, 0));
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < columns; j++) {
+                    for (size_t k = 0; k < rank; k++) {
+                        entries[i][j] ^= lower[i][k] & upper[k][j];
+                    }
+                }
+            }
+
+            const detail::BinaryMatrix matrix(entries);
+            REQUIRE(matrix.rank() == rank);
+            REQUIRE(detail::ModMatrix(entries, 2).rank() == rank);
+            REQUIRE(detail::rankOfMatrix(entries, 2) == static_cast<int>(rank));
+
+            const auto basis = matrix.nullspace();
+            REQUIRE(basis.size() == columns - rank);
+            for (const auto& vector : basis) {
+                for (size_t i = 0; i < rows; i++) {
+                    uint64_t sum = 0;
+                    for (size_t j = 0; j < columns; j++) {
+                        sum ^= entries[i][j] & vector[j];
+                    }
+                    REQUIRE(sum == 0);
+                }
+            }
+
+            std::vector<uint64_t> x(columns);
+            for (auto& item : x) {
+                item = random() & 1;
+            }
+            std::vector<uint64_t> rhs(rows, 0);
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < columns; j++) {
+                    rhs[i] ^= entries[i][j] & x[j];
+                }
+            }
+            const auto solution = matrix.solve(rhs);
+            REQUIRE(solution.has_value());
+            for (size_t i = 0; i < rows; i++) {
+                uint64_t sum = 0;
+                for (size_t j = 0; j < columns; j++) {
+                    sum ^= entries[i][j] & (*solution)[j];
+                }
+                REQUIRE(sum == rhs[i]);
+            }
         }
+
+        const detail::BinaryMatrix inconsistent({{1, 1}, {1, 1}});
+        REQUIRE_FALSE(inconsistent.solve({0, 1}).has_value());
+        REQUIRE(inconsistent.solve({1, 1}) == std::vector<uint64_t>{1, 0});
+        REQUIRE(detail::ModMatrix({{1, 1}, {1, 1}}, 2).nullspace() == std::vector<std::vector<uint64_t>>{{1, 1}});
     }
 
     SECTION("Count of Multiple roots") {